@@ -279,9 +279,12 @@ void AM_fix_10ms(const unsigned vfo)
     }
 #endif
 
+    // the RX line may be tuned to a channel that is not its VFO (N-watch)
+    const VFO_Info_t *pInfo = (vfo == gEeprom.RX_VFO) ? gRxVfo : &gEeprom.VfoInfo[vfo];
+
     static uint32_t lastFreq[2];
-    if(gEeprom.VfoInfo[vfo].pRX->Frequency != lastFreq[vfo]) {
-        lastFreq[vfo] = gEeprom.VfoInfo[vfo].pRX->Frequency;
+    if(pInfo->pRX->Frequency != lastFreq[vfo]) {
+        lastFreq[vfo] = pInfo->pRX->Frequency;
         AM_fix_reset(vfo);
     }
 
@@ -29,6 +29,9 @@
     #include "app/fm.h"
 #endif
 #include "app/scanner.h"
+#ifdef ENABLE_FEAT_F4HWN_SCAN_LOG
+    #include "app/scanlog.h"
+#endif
 #include "audio.h"
 #ifdef ENABLE_FMRADIO
     #include "driver/bk1080.h"
@@ -38,6 +41,7 @@
 #include "driver/backlight.h"
 #include "functions.h"
 #include "misc.h"
+#include "scheduler.h"
 #include "settings.h"
 #include "ui/inputbox.h"
 #include "ui/ui.h"
@@ -125,6 +129,9 @@ void (*action_opt_table[])(void) = {
     [ACTION_OPT_REGA_ALARM] = &ACTION_RegaAlarm,
     [ACTION_OPT_REGA_TEST] = &ACTION_RegaTest,
 #endif
+#ifdef ENABLE_FEAT_F4HWN_SCAN_LOG
+    [ACTION_OPT_SCAN_LOG] = &ACTION_ScanLog,
+#endif
 };
 
 static_assert(ARRAY_SIZE(action_opt_table) == ACTION_OPT_LEN);
@@ -160,15 +167,15 @@ void ACTION_Monitor(void)
     gMonitor = false;
 
     if (gScanStateDir != SCAN_OFF) {
-        gScanPauseDelayIn_10ms = scan_pause_delay_in_1_10ms;
-        gScheduleScanListen    = false;
+        SCHEDULER_StartTimer(&gScanPauseTimer, scan_pause_delay_in_1_10ms);
+        gScheduleScanListen = false;
         gScanPauseMode         = true;
     }
 
 #ifdef ENABLE_NOAA
     if (gEeprom.DUAL_WATCH == DUAL_WATCH_OFF && gIsNoaaMode) {
-        gNOAA_Countdown_10ms = NOAA_countdown_10ms;
-        gScheduleNOAA        = false;
+        SCHEDULER_StartTimer(&gNOAAScanTimer, NOAA_countdown_10ms);
+        gScheduleNOAA = false;
     }
 #endif
 
@@ -237,8 +244,8 @@ void ACTION_Scan(bool bRestart)
 
         // jump to the next channel
         CHFRSCANNER_Start(false, gScanStateDir);
-        gScanPauseDelayIn_10ms = 1;
-        gScheduleScanListen    = false;
+        SCHEDULER_StartTimer(&gScanPauseTimer, 1);
+        gScheduleScanListen = false;
     } else {
         #ifdef ENABLE_FEAT_F4HWN_RESUME_STATE
         if(gScanRangeStart == 0) // No ScanRange
@@ -666,4 +673,11 @@ void ACTION_BackLightOnDemand(void)
         gVfoConfigureMode = VFO_CONFIGURE_RELOAD;
     }
     #endif
-#endif
\ No newline at end of file
+#endif
+#ifdef ENABLE_FEAT_F4HWN_SCAN_LOG
+void ACTION_ScanLog(void)
+{
+    gScanLogCursor        = 0;
+    gRequestDisplayScreen = DISPLAY_SCANLOG;
+}
+#endif
@@ -36,10 +36,21 @@
 #include "app/generic.h"
 #include "app/main.h"
 #include "app/menu.h"
+#ifdef ENABLE_FEAT_F4HWN_NWATCH
+    #include "app/nwatch.h"
+#endif
+#ifdef ENABLE_FEAT_F4HWN_REMOTE_KEYS
+    #include "app/remote.h"
+#endif
+#ifdef ENABLE_FEAT_F4HWN_TELEMETRY
+    #include "app/telemetry.h"
+#endif
 #include "app/scanner.h"
+#ifdef ENABLE_FEAT_F4HWN_SCAN_LOG
+    #include "app/scanlog.h"
+#endif
 #if defined(ENABLE_UART) || defined(ENABLE_USB)
     #include "app/uart.h"
-    #include "scheduler.h"
 #endif
 #include "py32f0xx.h"
 #include "audio.h"
@@ -61,9 +72,15 @@
 #include "frequencies.h"
 #include "functions.h"
 #include "helper/battery.h"
+#ifdef ENABLE_FEAT_F4HWN_ADAPTIVE_SAVE
+    #include "helper/dutycycle.h"
+#endif
 #include "misc.h"
+#include "profiler.h"
 #include "radio.h"
+#include "scheduler.h"
 #include "settings.h"
+#include "task.h"
 
 #if defined(ENABLE_OVERLAY)
     #include "sram-overlay.h"
@@ -78,11 +95,20 @@
 #ifdef ENABLE_FEAT_F4HWN_SCREENSHOT
     #include "screenshot.h"
 #endif
+#if defined(ENABLE_FEAT_F4HWN_RX_LATENCY) && defined(ENABLE_FEAT_F4HWN_DEBUG) && defined(ENABLE_UART)
+    #include "debugging.h"
+#endif
 
 static bool flagSaveVfo;
 static bool flagSaveSettings;
 static bool flagSaveChannel;
 
+#ifdef ENABLE_FEAT_F4HWN_RX_LATENCY
+APP_RxLatency_t gRxLatency;
+static uint32_t sqlOpenTime_us;
+static bool     sqlOpenPending;
+#endif
+
 static void ProcessKey(KEY_Code_t Key, bool bKeyPressed, bool bKeyHeld);
 
 
@@ -91,6 +117,10 @@ void (*ProcessKeysFunctions[])(KEY_Code_t Key, bool bKeyPressed, bool bKeyHeld)
     [DISPLAY_MENU] = &MENU_ProcessKeys,
     [DISPLAY_SCANNER] = &SCANNER_ProcessKeys,
 
+#ifdef ENABLE_FEAT_F4HWN_SCAN_LOG
+    [DISPLAY_SCANLOG] = &SCANLOG_ProcessKeys,
+#endif
+
 #ifdef ENABLE_FMRADIO
     [DISPLAY_FM] = &FM_ProcessKeys,
 #endif
@@ -122,8 +152,8 @@ static void CheckForIncoming(void)
             #ifdef ENABLE_NOAA
                 if (gIsNoaaMode)
                 {
-                    gNOAA_Countdown_10ms = NOAA_countdown_3_10ms;
-                    gScheduleNOAA        = false;
+                    SCHEDULER_StartTimer(&gNOAAScanTimer, NOAA_countdown_3_10ms);
+                    gScheduleNOAA = false;
                 }
             #endif
 
@@ -148,8 +178,15 @@ static void CheckForIncoming(void)
             return;
         }
 
-        gDualWatchCountdown_10ms = dual_watch_count_after_rx_10ms;
-        gScheduleDualWatch       = false;
+#ifdef ENABLE_FEAT_F4HWN_NWATCH
+        NWATCH_MarkActivity();
+#endif
+
+        SCHEDULER_StartTimer(&gDualWatchTimer, dual_watch_count_after_rx_10ms);
+        gScheduleDualWatch = false;
+#ifdef ENABLE_FEAT_F4HWN_NWATCH
+        NWATCH_BeginPass();
+#endif
 
         // let the user see DW is not active
         gDualWatchActive = false;
@@ -167,8 +204,8 @@ static void CheckForIncoming(void)
             return;
         }
 
-        gScanPauseDelayIn_10ms = scan_pause_delay_in_3_10ms;
-        gScheduleScanListen    = false;
+        SCHEDULER_StartTimer(&gScanPauseTimer, scan_pause_delay_in_3_10ms);
+        gScheduleScanListen = false;
     }
 
     gRxReceptionMode = RX_MODE_DETECTED;
@@ -197,8 +234,8 @@ static void HandleIncoming(void)
     bool bFlag = (gScanStateDir == SCAN_OFF && gCurrentCodeType == CODE_TYPE_OFF);
 
 #ifdef ENABLE_NOAA
-    if (IS_NOAA_CHANNEL(gRxVfo->CHANNEL_SAVE) && gNOAACountdown_10ms > 0) {
-        gNOAACountdown_10ms = 0;
+    if (IS_NOAA_CHANNEL(gRxVfo->CHANNEL_SAVE) && SCHEDULER_IsTimerRunning(&gNOAACountdownTimer)) {
+        SCHEDULER_StopTimer(&gNOAACountdownTimer);
         bFlag               = true;
     }
 #endif
@@ -225,8 +262,11 @@ static void HandleIncoming(void)
             if (gRxReceptionMode != RX_MODE_DETECTED) {
                 return;
             }
-            gDualWatchCountdown_10ms = dual_watch_count_after_1_10ms;
-            gScheduleDualWatch       = false;
+            SCHEDULER_StartTimer(&gDualWatchTimer, dual_watch_count_after_1_10ms);
+            gScheduleDualWatch = false;
+#ifdef ENABLE_FEAT_F4HWN_NWATCH
+            NWATCH_BeginPass();
+#endif
 
             gRxReceptionMode = RX_MODE_LISTENING;
 
@@ -273,7 +313,7 @@ static void HandleReceive(void)
             break;
 
         case CODE_TYPE_CONTINUOUS_TONE:
-            if (gFoundCTCSS && gFoundCTCSSCountdown_10ms == 0)
+            if (gFoundCTCSS && !SCHEDULER_IsTimerRunning(&gFoundCTCSSTimer))
             {
                 gFoundCTCSS = false;
                 gFoundCDCSS = false;
@@ -284,7 +324,7 @@ static void HandleReceive(void)
 
         case CODE_TYPE_DIGITAL:
         case CODE_TYPE_REVERSE_DIGITAL:
-            if (gFoundCDCSS && gFoundCDCSSCountdown_10ms == 0)
+            if (gFoundCDCSS && !SCHEDULER_IsTimerRunning(&gFoundCDCSSTimer))
             {
                 gFoundCTCSS = false;
                 gFoundCDCSS = false;
@@ -323,8 +363,8 @@ static void HandleReceive(void)
                     else
                     if (!gFoundCTCSS)
                     {
-                        gFoundCTCSS               = true;
-                        gFoundCTCSSCountdown_10ms = 100;   // 1 sec
+                        gFoundCTCSS = true;
+                        SCHEDULER_StartTimer(&gFoundCTCSSTimer, 100);   // 1 sec
                     }
 
                     if (g_CxCSS_TAIL_Found)
@@ -343,8 +383,8 @@ static void HandleReceive(void)
                     else
                     if (!gFoundCDCSS)
                     {
-                        gFoundCDCSS               = true;
-                        gFoundCDCSSCountdown_10ms = 100;   // 1 sec
+                        gFoundCDCSS = true;
+                        SCHEDULER_StartTimer(&gFoundCDCSSTimer, 100);   // 1 sec
                     }
 
                     if (g_CxCSS_TAIL_Found)
@@ -383,7 +423,7 @@ Skip:
 
             #ifdef ENABLE_NOAA
                 if (IS_NOAA_CHANNEL(gRxVfo->CHANNEL_SAVE))
-                    gNOAACountdown_10ms = 300;         // 3 sec
+                    SCHEDULER_StartTimer(&gNOAACountdownTimer, 300);   // 3 sec
             #endif
 
             gUpdateDisplay = true;
@@ -398,8 +438,8 @@ Skip:
                         break;
 
                     case SCAN_RESUME_CO:
-                        gScanPauseDelayIn_10ms = scan_pause_delay_in_7_10ms;
-                        gScheduleScanListen    = false;
+                        SCHEDULER_StartTimer(&gScanPauseTimer, scan_pause_delay_in_7_10ms);
+                        gScheduleScanListen = false;
                         break;
 
                     case SCAN_RESUME_SE:
@@ -416,16 +456,16 @@ Skip:
                     }
                     else
                     {
-                        gScanPauseDelayIn_10ms = gEeprom.SCAN_RESUME_MODE * (250 / 10); // 250ms
-                        gScheduleScanListen    = false;
+                        SCHEDULER_StartTimer(&gScanPauseTimer, gEeprom.SCAN_RESUME_MODE * (250 / 10)); // 250ms
+                        gScheduleScanListen = false;
                     }
                 }
 
                 /*
                 if(gEeprom.SCAN_RESUME_MODE < 2)
                 {
-                    gScanPauseDelayIn_10ms = scan_pause_delay_in_6_10ms + (scan_pause_delay_in_6_10ms * 24 * gEeprom.SCAN_RESUME_MODE);
-                    gScheduleScanListen    = false;
+                    SCHEDULER_StartTimer(&gScanPauseTimer, scan_pause_delay_in_6_10ms + (scan_pause_delay_in_6_10ms * 24 * gEeprom.SCAN_RESUME_MODE));
+                    gScheduleScanListen = false;
 
                 }
                 else if(gEeprom.SCAN_RESUME_MODE == 2)
@@ -438,13 +478,13 @@ Skip:
                 switch (gEeprom.SCAN_RESUME_MODE)
                 {
                     case 0:
-                        gScanPauseDelayIn_10ms = scan_pause_delay_in_6_10ms;
-                        gScheduleScanListen    = false;
+                        SCHEDULER_StartTimer(&gScanPauseTimer, scan_pause_delay_in_6_10ms);
+                        gScheduleScanListen = false;
                         break;
 
                     case 1:
-                        gScanPauseDelayIn_10ms = scan_pause_delay_in_2_10ms * 5;
-                        gScheduleScanListen    = false;
+                        SCHEDULER_StartTimer(&gScanPauseTimer, scan_pause_delay_in_2_10ms * 5);
+                        gScheduleScanListen = false;
                         break;
 
                     case 26:
@@ -464,7 +504,7 @@ Skip:
             if (gEeprom.TAIL_TONE_ELIMINATION) {
                 AUDIO_AudioPathOff();
 
-                gTailNoteEliminationCountdown_10ms = 20;
+                SCHEDULER_StartTimer(&gTailNoteEliminationTimer, 20);
                 gFlagTailNoteEliminationComplete   = false;
                 gEndOfRxDetectedMaybe = true;
                 gEnableSpeaker        = false;
@@ -521,6 +561,18 @@ void APP_StartListening(FUNCTION_Type_t function)
     AUDIO_AudioPathOn();
     gEnableSpeaker = true;
 
+#ifdef ENABLE_FEAT_F4HWN_RX_LATENCY
+    if (sqlOpenPending) {
+        sqlOpenPending     = false;
+        gRxLatency.Last_us = SCHEDULER_GetMicros() - sqlOpenTime_us;
+        gRxLatency.Max_us  = MAX(gRxLatency.Max_us, gRxLatency.Last_us);
+        gRxLatency.Count++;
+        #if defined(ENABLE_FEAT_F4HWN_DEBUG) && defined(ENABLE_UART)
+            LogUartf("RX latency %lu us\r\n", (unsigned long)gRxLatency.Last_us);
+        #endif
+    }
+#endif
+
     if (gSetting_backlight_on_tx_rx & BACKLIGHT_ON_TR_RX) {
         BACKLIGHT_TurnOn();
     }
@@ -535,8 +587,8 @@ void APP_StartListening(FUNCTION_Type_t function)
         gRxVfo->pTX->Frequency      = NoaaFrequencyTable[gNoaaChannel];
         gEeprom.ScreenChannel[vfo] = gRxVfo->CHANNEL_SAVE;
 
-        gNOAA_Countdown_10ms        = 500;   // 5 sec
-        gScheduleNOAA               = false;
+        SCHEDULER_StartTimer(&gNOAAScanTimer, 500);   // 5 sec
+        gScheduleNOAA = false;
     }
 #endif
 
@@ -544,8 +596,11 @@ void APP_StartListening(FUNCTION_Type_t function)
         gEeprom.DUAL_WATCH != DUAL_WATCH_OFF)
     {   // not scanning, dual watch is enabled
 
-        gDualWatchCountdown_10ms = dual_watch_count_after_2_10ms;
-        gScheduleDualWatch       = false;
+        SCHEDULER_StartTimer(&gDualWatchTimer, dual_watch_count_after_2_10ms);
+        gScheduleDualWatch = false;
+#ifdef ENABLE_FEAT_F4HWN_NWATCH
+        NWATCH_BeginPass();
+#endif
 
         // when crossband is active only the main VFO should be used for TX
         if(gEeprom.CROSS_BAND_RX_TX == CROSS_BAND_OFF)
@@ -632,8 +687,12 @@ static void DualwatchAlternate(void)
         else
     #endif
     {   // toggle between VFO's
+#ifdef ENABLE_FEAT_F4HWN_NWATCH
+        NWATCH_Next();
+#else
         gEeprom.RX_VFO = !gEeprom.RX_VFO;
         gRxVfo         = &gEeprom.VfoInfo[gEeprom.RX_VFO];
+#endif
 
         if (!gDualWatchActive)
         {   // let the user see DW is active
@@ -644,13 +703,34 @@ static void DualwatchAlternate(void)
 
     RADIO_SetupRegisters(false);
 
+    #ifdef ENABLE_FEAT_F4HWN_NWATCH
+        const uint16_t toggle_10ms = NWATCH_GetDwell_10ms();
+    #else
+        const uint16_t toggle_10ms = dual_watch_count_toggle_10ms;
+    #endif
+
     #ifdef ENABLE_NOAA
-        gDualWatchCountdown_10ms = gIsNoaaMode ? dual_watch_count_noaa_10ms : dual_watch_count_toggle_10ms;
+        SCHEDULER_StartTimer(&gDualWatchTimer, gIsNoaaMode ? dual_watch_count_noaa_10ms : toggle_10ms);
     #else
-        gDualWatchCountdown_10ms = dual_watch_count_toggle_10ms;
+        SCHEDULER_StartTimer(&gDualWatchTimer, toggle_10ms);
     #endif
 }
 
+#ifdef ENABLE_DTMF_CALLING
+// the decoder needs a few ms before the request can be answered
+static TASK_t dtmfRequestTask;
+
+static TASK_State_t DtmfRequestTask(TASK_t *pTask)
+{
+    TASK_BEGIN(pTask);
+
+    TASK_DELAY_MS(pTask, 3);    //fix DTMF not reply@Yurisu
+    DTMF_HandleRequest();
+
+    TASK_END(pTask);
+}
+#endif
+
 static void CheckRadioInterrupts(void)
 {
     if (SCANNER_IsScanning())
@@ -719,9 +799,8 @@ static void CheckRadioInterrupts(void)
                         gDTMF_RX[gDTMF_RX_index]   = 0;
                         gDTMF_RX_timeout           = DTMF_RX_timeout_500ms;  // time till we delete it
                         gDTMF_RX_pending           = true;
-                        
-                        SYSTEM_DelayMs(3);//fix DTMF not reply@Yurisu
-                        DTMF_HandleRequest();
+
+                        TASK_Start(&dtmfRequestTask);
                     }
 #endif
                 }
@@ -752,13 +831,16 @@ static void CheckRadioInterrupts(void)
 
             if (gEeprom.VOX_SWITCH) {
                 if (gCurrentFunction == FUNCTION_POWER_SAVE && !gRxIdleMode) {
-                    gPowerSave_10ms            = power_save2_10ms;
+                    SCHEDULER_StartTimer(&gPowerSaveTimer, power_save2_10ms);
                     gPowerSaveCountdownExpired = 0;
                 }
 
-                if (gEeprom.DUAL_WATCH != DUAL_WATCH_OFF && (gScheduleDualWatch || gDualWatchCountdown_10ms < dual_watch_count_after_vox_10ms)) {
-                    gDualWatchCountdown_10ms = dual_watch_count_after_vox_10ms;
+                if (gEeprom.DUAL_WATCH != DUAL_WATCH_OFF && (gScheduleDualWatch || SCHEDULER_GetTimerRemaining(&gDualWatchTimer) < dual_watch_count_after_vox_10ms)) {
+                    SCHEDULER_StartTimer(&gDualWatchTimer, dual_watch_count_after_vox_10ms);
                     gScheduleDualWatch = false;
+#ifdef ENABLE_FEAT_F4HWN_NWATCH
+                    NWATCH_BeginPass();
+#endif
 
                     // let the user see DW is not active
                     gDualWatchActive = false;
@@ -774,6 +856,13 @@ static void CheckRadioInterrupts(void)
 #endif
 
         if (interrupts.sqlLost) {
+#ifdef ENABLE_FEAT_F4HWN_RX_LATENCY
+            sqlOpenTime_us = SCHEDULER_GetMicros();
+            sqlOpenPending = true;
+#endif
+#ifdef ENABLE_FEAT_F4HWN_ADAPTIVE_SAVE
+            DUTYCYCLE_MarkActivity();
+#endif
             g_SquelchLost = true;
             BK4819_ToggleGpioOut(BK4819_GPIO6_PIN2_GREEN, true);
             #ifdef ENABLE_FEAT_F4HWN_RX_TX_TIMER
@@ -782,6 +871,9 @@ static void CheckRadioInterrupts(void)
         }
 
         if (interrupts.sqlFound) {
+#ifdef ENABLE_FEAT_F4HWN_RX_LATENCY
+            sqlOpenPending = false;
+#endif
             g_SquelchLost = false;
             BK4819_ToggleGpioOut(BK4819_GPIO6_PIN2_GREEN, false);
         }
@@ -845,8 +937,8 @@ static void HandleVox(void)
 
     if (gVOX_NoiseDetected) {
         if (g_VOX_Lost)
-            gVoxStopCountdown_10ms = vox_stop_count_down_10ms;
-        else if (gVoxStopCountdown_10ms == 0)
+            SCHEDULER_StartTimer(&gVoxStopTimer, vox_stop_count_down_10ms);
+        else if (!SCHEDULER_IsTimerRunning(&gVoxStopTimer))
             gVOX_NoiseDetected = false;
 
         if (gCurrentFunction == FUNCTION_TRANSMIT && !gPttIsPressed && !gVOX_NoiseDetected) {
@@ -891,19 +983,29 @@ static void HandleVox(void)
 
 void APP_Update(void)
 {
+    AUDIO_RunBeep();
+
+#ifdef ENABLE_DTMF_CALLING
+    if (TASK_IsRunning(&dtmfRequestTask))
+        DtmfRequestTask(&dtmfRequestTask);
+#endif
+
 #ifdef ENABLE_VOICE
-    if (gFlagPlayQueuedVoice) {
+    if (gFlagPlayQueuedVoice && !AUDIO_IsBeepPlaying()) {
             AUDIO_PlayQueuedVoice();
             gFlagPlayQueuedVoice = false;
     }
 #endif
 
 #ifdef ENABLE_USB
-    if (UART_IsCommandAvailable(UART_PORT_VCP)) {
+    for (int i = 0; i < UART_VCP_PIPELINE_DEPTH && UART_IsCommandAvailable(UART_PORT_VCP); i++) {
         // SCHEDULER_Disable();
-        UART_HandleCommand(UART_PORT_VCP);
+        PROFILE(PROFILER_UART, UART_HandleCommand(UART_PORT_VCP));
         // SCHEDULER_Enable();
     }
+
+    // replies of this pass go out together, or once the previous batch is done
+    UART_FlushReplies(UART_PORT_VCP);
 #endif
 
 #ifdef ENABLE_FEAT_F4HWN
@@ -996,6 +1098,11 @@ void APP_Update(void)
         GUI_DisplayScreen();
     }
 
+    // whatever reprograms the radio waits for the end of the beep, the UART
+    // and the 10ms timeslice keep being served meanwhile
+    if (AUDIO_IsBeepPlaying())
+        return;
+
     if (gReducedService)
         return;
 
@@ -1027,8 +1134,8 @@ void APP_Update(void)
             NOAA_IncreaseChannel();
             RADIO_SetupRegisters(false);
 
-            gNOAA_Countdown_10ms = 7;      // 70ms
-            gScheduleNOAA        = false;
+            SCHEDULER_StartTimer(&gNOAAScanTimer, 7);      // 70ms
+            gScheduleNOAA = false;
         }
 #endif
 
@@ -1091,7 +1198,7 @@ void APP_Update(void)
             || (gIsNoaaMode && (IS_NOAA_CHANNEL(gEeprom.ScreenChannel[0]) || IS_NOAA_CHANNEL(gEeprom.ScreenChannel[1])))
 #endif
         ) {
-            gBatterySaveCountdown_10ms = battery_save_count_10ms;
+            SCHEDULER_StartTimer(&gBatterySaveTimer, battery_save_count_10ms);
         } else {
             FUNCTION_Select(FUNCTION_POWER_SAVE);
         }
@@ -1109,6 +1216,9 @@ void APP_Update(void)
         if (gRxIdleMode)
         {
             BK4819_Conditional_RX_TurnOn_and_GPIO6_Enable();
+#ifdef ENABLE_FEAT_F4HWN_STOP
+            SCHEDULER_MarkRxOn();
+#endif
 
 #ifdef ENABLE_VOX
             if (gEeprom.VOX_SWITCH)
@@ -1119,13 +1229,16 @@ void APP_Update(void)
                 gScanStateDir == SCAN_OFF &&
                 !gCssBackgroundScan)
             {   // dual watch mode, toggle between the two VFO's
+#ifdef ENABLE_FEAT_F4HWN_NWATCH
+                NWATCH_BeginPass();
+#endif
                 DualwatchAlternate();
                 goToSleep = false;
             }
 
             FUNCTION_Init();
 
-            gPowerSave_10ms = power_save1_10ms; // come back here in a bit
+            SCHEDULER_StartTimer(&gPowerSaveTimer, power_save1_10ms); // come back here in a bit
             gRxIdleMode     = false;            // RX is awake
         }
         else if (gEeprom.DUAL_WATCH == DUAL_WATCH_OFF || gScanStateDir != SCAN_OFF || gCssBackgroundScan || goToSleep)
@@ -1135,14 +1248,20 @@ void APP_Update(void)
 #ifdef ENABLE_FEAT_F4HWN_SLEEP
             if(gWakeUp)
             {
-                gPowerSave_10ms = gEeprom.BATTERY_SAVE * 200; // deep sleep now indexed on BatSav
+                SCHEDULER_StartTimer(&gPowerSaveTimer, gEeprom.BATTERY_SAVE * 200); // deep sleep now indexed on BatSav
             }
             else
             {
-                gPowerSave_10ms = gEeprom.BATTERY_SAVE * 10;
+    #ifdef ENABLE_FEAT_F4HWN_ADAPTIVE_SAVE
+                SCHEDULER_StartTimer(&gPowerSaveTimer, DUTYCYCLE_NextOff_10ms());
+    #else
+                SCHEDULER_StartTimer(&gPowerSaveTimer, gEeprom.BATTERY_SAVE * 10);
+    #endif
             }
+#elif defined(ENABLE_FEAT_F4HWN_ADAPTIVE_SAVE)
+            SCHEDULER_StartTimer(&gPowerSaveTimer, DUTYCYCLE_NextOff_10ms());
 #else
-            gPowerSave_10ms = gEeprom.BATTERY_SAVE * 10;
+            SCHEDULER_StartTimer(&gPowerSaveTimer, gEeprom.BATTERY_SAVE * 10);
 #endif
             gRxIdleMode     = true;
             goToSleep = false;
@@ -1157,14 +1276,30 @@ void APP_Update(void)
         else {
             // toggle between the two VFO's
             DualwatchAlternate();
-            gPowerSave_10ms   = power_save1_10ms;
+            SCHEDULER_StartTimer(&gPowerSaveTimer, power_save1_10ms);
+#ifdef ENABLE_FEAT_F4HWN_NWATCH
+            goToSleep = NWATCH_PassComplete(); // sleep once every watched slot got a look
+#else
             goToSleep = true;
+#endif
         }
 
         gPowerSaveCountdownExpired = false;
     }
 }
 
+#ifdef ENABLE_FEAT_F4HWN
+// the PTT line or a PTT press injected over the command channel
+static bool IsPttPressed(void)
+{
+#ifdef ENABLE_FEAT_F4HWN_REMOTE_KEYS
+    if (REMOTE_IsPttPressed())
+        return true;
+#endif
+    return GPIO_IsPttPressed();
+}
+#endif
+
 // called every 10ms
 static void CheckKeys(void)
 {
@@ -1184,18 +1319,18 @@ static void CheckKeys(void)
 #ifdef ENABLE_FEAT_F4HWN
     if (gSetting_set_ptt_session)
     {
-        if (GPIO_IsPttPressed() && !SerialConfigInProgress() && gPttOnePushCounter == 0)
+        if (IsPttPressed() && !SerialConfigInProgress() && gPttOnePushCounter == 0)
         {   // PTT pressed
             if (++gPttDebounceCounter >= 3)     // 30ms
             {   // start transmitting
-                boot_counter_10ms   = 0;
+                SCHEDULER_StopTimer(&gBootTimer);
                 gPttDebounceCounter = 0;
                 gPttIsPressed       = true;
                 gPttOnePushCounter = 1;
                 ProcessKey(KEY_PTT, true, false);
             }
         }
-        else if ((!GPIO_IsPttPressed() || SerialConfigInProgress()) && gPttOnePushCounter == 1)
+        else if ((!IsPttPressed() || SerialConfigInProgress()) && gPttOnePushCounter == 1)
         {   
             // PTT released or serial comms config in progress
             if (++gPttDebounceCounter >= 3 || SerialConfigInProgress())     // 30ms
@@ -1203,14 +1338,14 @@ static void CheckKeys(void)
                 gPttOnePushCounter = 2;
             }
         }
-        else if (GPIO_IsPttPressed() && !SerialConfigInProgress() && gPttOnePushCounter == 2)
+        else if (IsPttPressed() && !SerialConfigInProgress() && gPttOnePushCounter == 2)
         {   // PTT pressed again            
             if (++gPttDebounceCounter >= 3 || SerialConfigInProgress())     // 30ms
             {   // stop transmitting
                 gPttOnePushCounter = 3;
             }
         }
-        else if ((!GPIO_IsPttPressed() || SerialConfigInProgress()) && gPttOnePushCounter == 3)
+        else if ((!IsPttPressed() || SerialConfigInProgress()) && gPttOnePushCounter == 3)
         {   // PTT released or serial comms config in progress
             if (++gPttDebounceCounter >= 3 || SerialConfigInProgress())     // 30ms
             {   // stop transmitting
@@ -1233,7 +1368,7 @@ static void CheckKeys(void)
     {
         if (gPttIsPressed)
         {
-            if (!GPIO_IsPttPressed() || SerialConfigInProgress())
+            if (!IsPttPressed() || SerialConfigInProgress())
             {   // PTT released or serial comms config in progress
                 if (++gPttDebounceCounter >= 3 || SerialConfigInProgress())     // 30ms
                 {   // stop transmitting
@@ -1249,11 +1384,11 @@ static void CheckKeys(void)
             else
                 gPttDebounceCounter = 0;
         }
-        else if (GPIO_IsPttPressed() && !SerialConfigInProgress())
+        else if (IsPttPressed() && !SerialConfigInProgress())
         {   // PTT pressed
             if (++gPttDebounceCounter >= 3)     // 30ms
             {   // start transmitting
-                boot_counter_10ms   = 0;
+                SCHEDULER_StopTimer(&gBootTimer);
                 gPttDebounceCounter = 0;
                 gPttIsPressed       = true;
                 ProcessKey(KEY_PTT, true, false);
@@ -1282,7 +1417,7 @@ static void CheckKeys(void)
     {   // PTT pressed
         if (++gPttDebounceCounter >= 3)     // 30ms
         {   // start transmitting
-            boot_counter_10ms   = 0;
+            SCHEDULER_StopTimer(&gBootTimer);
             gPttDebounceCounter = 0;
             gPttIsPressed       = true;
             ProcessKey(KEY_PTT, true, false);
@@ -1297,8 +1432,13 @@ static void CheckKeys(void)
     // scan the hardware keys
     KEY_Code_t Key = KEYBOARD_Poll();
 
+#ifdef ENABLE_FEAT_F4HWN_REMOTE_KEYS
+    if (Key == KEY_INVALID)
+        Key = REMOTE_GetKey();
+#endif
+
     if (Key != KEY_INVALID) // any key pressed
-        boot_counter_10ms = 0;   // cancel boot screen/beeps if any key pressed
+        SCHEDULER_StopTimer(&gBootTimer);   // cancel boot screen/beeps if any key pressed
 
     if (gKeyReading0 != Key) // new key pressed
     {
@@ -1367,23 +1507,31 @@ void APP_TimeSlice10ms(void)
 
 #ifdef ENABLE_AM_FIX
     if (gRxVfo->Modulation == MODULATION_AM) {
-        AM_fix_10ms(gEeprom.RX_VFO);
+        PROFILE(PROFILER_AM_FIX, AM_fix_10ms(gEeprom.RX_VFO));
     }
 #endif
 
 #ifdef ENABLE_UART
     if (UART_IsCommandAvailable(UART_PORT_UART)) {
         // SCHEDULER_Disable();
-        UART_HandleCommand(UART_PORT_UART);
+        PROFILE(PROFILER_UART, UART_HandleCommand(UART_PORT_UART));
         // SCHEDULER_Enable();
     }
 #endif
 
+#ifdef ENABLE_FEAT_F4HWN_SCREENSHOT
+    PROFILE(PROFILER_SCREENSHOT, SCREENSHOT_TimeSlice10ms());
+#endif
+
+#ifdef ENABLE_FEAT_F4HWN_TELEMETRY
+    TELEMETRY_TimeSlice10ms();
+#endif
+
     if (gReducedService)
         return;
 
     if (gCurrentFunction != FUNCTION_POWER_SAVE || !gRxIdleMode)
-        CheckRadioInterrupts();
+        PROFILE(PROFILER_RADIO_IRQ, CheckRadioInterrupts());
 
     if (gCurrentFunction == FUNCTION_TRANSMIT)
     {   // transmitting
@@ -1396,9 +1544,25 @@ void APP_TimeSlice10ms(void)
     bool gUpdateDisplayCurrent = gUpdateDisplay;
     bool gUpdateStatusCurrent  = gUpdateStatus;
 
+    if (gWelcomeHold) {
+        // the boot-up screen stays until its timer ends or a key cuts it short
+        if (SCHEDULER_IsTimerRunning(&gBootTimer)) {
+            gUpdateDisplayCurrent = false;
+            gUpdateStatusCurrent  = false;
+        }
+        else {
+            gWelcomeHold          = false;
+            gUpdateDisplayCurrent = true;
+            gUpdateStatusCurrent  = true;
+        }
+    }
+
     if (gUpdateDisplayCurrent) {
         gUpdateDisplay = false;
         GUI_DisplayScreen();
+#ifdef ENABLE_FEAT_F4HWN_REMOTE_KEYS
+        REMOTE_ScreenUpdated();
+#endif
     }
 
     if (gUpdateStatusCurrent) {
@@ -1504,6 +1668,10 @@ void APP_TimeSlice10ms(void)
 
     SCANNER_TimeSlice10ms();
 
+#ifdef ENABLE_FEAT_F4HWN_SCAN_LOG
+    SCANLOG_TimeSlice10ms();
+#endif
+
 #ifdef ENABLE_AIRCOPY
     if (gScreenToDisplay == DISPLAY_AIRCOPY && gAircopyState == AIRCOPY_TRANSFER && gAirCopyIsSendMode == 1) {
         if (!AIRCOPY_SendMessage()) {
@@ -1512,8 +1680,25 @@ void APP_TimeSlice10ms(void)
     }
 #endif
 
+#ifdef ENABLE_FEAT_F4HWN_REMOTE_KEYS
+    REMOTE_TimeSlice10ms();
+#endif
+
+#ifdef ENABLE_FEAT_F4HWN_WFI
+    // this scan also serves a key that woke the core up since the last one
+    SCHEDULER_TakeEvent(SCHEDULER_EVENT_KEY);
+#endif
+    CheckKeys();
+}
+
+#ifdef ENABLE_FEAT_F4HWN_WFI
+// a key or the PTT woke the core up between two ticks: take the first sample
+// now instead of on the next tick, the debounce counts on from there
+void APP_KeyWake(void)
+{
     CheckKeys();
 }
+#endif
 
 void cancelUserInputModes(void)
 {
@@ -1621,7 +1806,7 @@ void APP_TimeSlice500ms(void)
         //ST7565_Init();
         ST7565_FixInterfGlitch();
         BK4819_ToggleGpioOut(BK4819_GPIO5_PIN1_RED, false);
-        gPowerSave_10ms = gEeprom.BATTERY_SAVE * 10;
+        SCHEDULER_StartTimer(&gPowerSaveTimer, gEeprom.BATTERY_SAVE * 10);
         gWakeUp = false;
     }
 
@@ -1633,7 +1818,7 @@ void APP_TimeSlice500ms(void)
     {
         if (gSleepModeCountdown_500ms > 0 && --gSleepModeCountdown_500ms == 0) {
             gBacklightCountdown_500ms = 0;
-            gPowerSave_10ms = 1;
+            SCHEDULER_StartTimer(&gPowerSaveTimer, 1);
             gWakeUp = true;
             // TODO:
             // PWM_PLUS0_CH0_COMP = 0;
@@ -1792,6 +1977,10 @@ void APP_TimeSlice500ms(void)
     SCANNER_TimeSlice500ms();
     UI_MAIN_TimeSlice500ms();
 
+#ifdef ENABLE_FEAT_F4HWN_SCAN_LOG
+    SCANLOG_TimeSlice500ms();
+#endif
+
 #ifdef ENABLE_DTMF_CALLING
     if (gCurrentFunction != FUNCTION_TRANSMIT) {
         if (gDTMF_DecodeRingCountdown_500ms > 0) {
@@ -1847,8 +2036,35 @@ static void ALARM_Off(void)
 }
 #endif
 
+// what a key handler left for ProcessKey() to do after the beep starts
+static bool KeySideEffectsPending(void)
+{
+    return gFlagAcceptSetting
+        || gRequestSaveSettings
+        || gRequestSaveVFO
+        || gRequestSaveChannel > 0
+        || gVfoConfigureMode != VFO_CONFIGURE_NONE
+        || gFlagReconfigureVfos
+        || gFlagPrepareTX
+#ifdef ENABLE_FMRADIO
+        || gRequestSaveFM
+#endif
+#ifdef ENABLE_VOICE
+        || gAnotherVoiceID != VOICE_ID_INVALID
+#endif
+        ;
+}
+
 static void ProcessKey(KEY_Code_t Key, bool bKeyPressed, bool bKeyHeld)
 {
+#ifdef ENABLE_FEAT_F4HWN_REMOTE_KEYS
+    REMOTE_KeyProcessed(Key, bKeyPressed, bKeyHeld);
+#endif
+
+    // a new key press may drive the radio right away
+    if (bKeyPressed || Key == KEY_PTT)
+        AUDIO_CompleteBeep();
+
     #ifdef ENABLE_FEAT_F4HWN_SLEEP
     if(gWakeUp)
     {
@@ -1878,7 +2094,7 @@ static void ProcessKey(KEY_Code_t Key, bool bKeyPressed, bool bKeyHeld)
     if (gCurrentFunction == FUNCTION_POWER_SAVE)
         FUNCTION_Select(FUNCTION_FOREGROUND);
 
-    gBatterySaveCountdown_10ms = battery_save_count_10ms;
+    SCHEDULER_StartTimer(&gBatterySaveTimer, battery_save_count_10ms);
 
     if (gEeprom.AUTO_KEYPAD_LOCK)
         gKeyLockCountdown = gEeprom.AUTO_KEYPAD_LOCK * 30;     // 15 seconds step
@@ -2146,10 +2362,14 @@ static void ProcessKey(KEY_Code_t Key, bool bKeyPressed, bool bKeyHeld)
 
 Skip:
     if (gBeepToPlay != BEEP_NONE) {
-        AUDIO_PlayBeep(gBeepToPlay);
+        AUDIO_StartBeep(gBeepToPlay);
         gBeepToPlay = BEEP_NONE;
     }
 
+    // radio and flash work below keeps coming after the beep, as it always did
+    if (KeySideEffectsPending())
+        AUDIO_CompleteBeep();
+
     if (gFlagAcceptSetting) {
         gMenuCountdown = menu_timeout_500ms;
 
@@ -2224,6 +2444,10 @@ Skip:
     if (gFlagReconfigureVfos) {
         RADIO_SelectVfos();
 
+#ifdef ENABLE_FEAT_F4HWN_NWATCH
+        NWATCH_Invalidate();
+#endif
+
 #ifdef ENABLE_NOAA
         RADIO_ConfigureNOAA();
 #endif
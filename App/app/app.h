@@ -30,6 +30,20 @@ uint32_t APP_SetFrequencyByStep(VFO_Info_t *pInfo, int8_t direction);
 void     APP_Update(void);
 void     APP_TimeSlice10ms(void);
 void     APP_TimeSlice500ms(void);
+#ifdef ENABLE_FEAT_F4HWN_WFI
+void     APP_KeyWake(void);
+#endif
+
+#ifdef ENABLE_FEAT_F4HWN_RX_LATENCY
+// from the poll that saw the squelch open to the audio path being on
+typedef struct {
+    uint32_t Last_us;
+    uint32_t Max_us;
+    uint32_t Count;
+} APP_RxLatency_t;
+
+extern APP_RxLatency_t gRxLatency;
+#endif
 
 #endif
 
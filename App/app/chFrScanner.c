@@ -1,10 +1,22 @@
 
 #include "app/app.h"
 #include "app/chFrScanner.h"
+#ifdef ENABLE_FEAT_F4HWN_SCAN_LOG
+    #include "app/scanlog.h"
+#endif
+#ifdef ENABLE_FEAT_F4HWN_COARSE_SCAN
+    #include "driver/bk4819.h"
+    #include "driver/systick.h"
+    #include "frequencies.h"
+#endif
 #include "functions.h"
 #include "misc.h"
+#include "scheduler.h"
 #include "settings.h"
 //#include "debugging.h"
+#if defined(ENABLE_FEAT_F4HWN_COARSE_SCAN) && defined(ENABLE_FEAT_F4HWN_DEBUG) && defined(ENABLE_UART)
+    #include "debugging.h"
+#endif
 
 int8_t            gScanStateDir;
 bool              gScanKeepResult;
@@ -34,6 +46,40 @@ uint8_t             initialCROSS_BAND_RX_TX;
     uint32_t lastFoundFrqOrChanOld;
 #endif
 
+uint16_t            gScanFirstHit_10ms;
+static uint32_t     scanStartTick;
+
+#ifdef ENABLE_FEAT_F4HWN_COARSE_SCAN
+// Frequency scan in two passes. The coarse pass sweeps COARSE_STEP wide bins
+// with the widest IF filter, the fast BK4819_TuneTo() path and the raw RSSI,
+// COARSE_BLOCK bins per 10ms tick: a bin takes up to ~1.8ms to settle, which
+// keeps a tick well within its slice. A bin standing COARSE_MARGIN above the
+// noise floor gets a fine pass over the StepFrequency grid it covers, at the
+// same COARSE_BLOCK bins per tick, and the strongest fine bin is then tuned
+// the normal way for the squelch to decide, as a regular single step scan
+// would have done. The BK4819 interrupts stay masked while parked on the
+// bins, RADIO_SetupRegisters() sets them up again for that last step.
+#define COARSE_STEP      2500u                  // 25kHz
+#define COARSE_BLOCK     2
+#define COARSE_MARGIN    12                     // 6dB
+#define COARSE_SETTLE_US 800
+#define COARSE_BW_REG_43 0b0011011000101000     // 25kHz, same as spectrum
+
+typedef enum {
+    SCAN_PASS_COARSE = 0,
+    SCAN_PASS_FINE,
+    SCAN_PASS_CONFIRM
+} scan_pass_t;
+
+static scan_pass_t  scanPass;
+static uint32_t     coarseFreq;
+static uint16_t     noiseFloor;
+static uint32_t     fineFreq;
+static uint32_t     fineEnd;
+static uint32_t     fineBest;
+static uint16_t     finePeak;
+#endif
+
 static void NextFreqChannel(void);
 static void NextMemChannel(void);
 
@@ -47,6 +93,11 @@ void CHFRSCANNER_Start(const bool storeBackupSettings, const int8_t scan_directi
     
     RADIO_SelectVfos();
 
+    if (storeBackupSettings) {
+        gScanFirstHit_10ms = 0;
+        scanStartTick      = SCHEDULER_GetTicks_10ms();
+    }
+
     gNextMrChannel   = gRxVfo->CHANNEL_SAVE;
     currentScanList = SCAN_NEXT_CHAN_SCANLIST1;
     gScanStateDir    = scan_direction;
@@ -65,6 +116,11 @@ void CHFRSCANNER_Start(const bool storeBackupSettings, const int8_t scan_directi
             initialFrqOrChan = gRxVfo->freq_config_RX.Frequency;
             lastFoundFrqOrChan = initialFrqOrChan;
         }
+#ifdef ENABLE_FEAT_F4HWN_COARSE_SCAN
+        scanPass   = SCAN_PASS_CONFIRM;
+        coarseFreq = gRxVfo->freq_config_RX.Frequency;
+        noiseFloor = 0;
+#endif
         NextFreqChannel();
     }
 
@@ -72,8 +128,8 @@ void CHFRSCANNER_Start(const bool storeBackupSettings, const int8_t scan_directi
     lastFoundFrqOrChanOld = lastFoundFrqOrChan;
 #endif
 
-    gScanPauseDelayIn_10ms = scan_pause_delay_in_2_10ms;
-    gScheduleScanListen    = false;
+    SCHEDULER_StartTimer(&gScanPauseTimer, scan_pause_delay_in_2_10ms);
+    gScheduleScanListen = false;
     gRxReceptionMode       = RX_MODE_NONE;
     gScanPauseMode         = false;
 }
@@ -111,6 +167,9 @@ void CHFRSCANNER_ContinueScanning(void)
     }
     else
     {
+#ifdef ENABLE_FEAT_F4HWN_SCAN_LOG
+        SCANLOG_End();
+#endif
         IS_FREQ_CHANNEL(gNextMrChannel) ? NextFreqChannel() : NextMemChannel();
     }
 
@@ -123,11 +182,11 @@ void CHFRSCANNER_Found(void)
 {
     if (gEeprom.SCAN_RESUME_MODE > 80) {
         if (!gScanPauseMode) {
-            gScanPauseDelayIn_10ms = scan_pause_delay_in_5_10ms * (gEeprom.SCAN_RESUME_MODE - 80) * 5;
+            SCHEDULER_StartTimer(&gScanPauseTimer, scan_pause_delay_in_5_10ms * (gEeprom.SCAN_RESUME_MODE - 80) * 5);
             gScanPauseMode = true;
         }
     } else {
-        gScanPauseDelayIn_10ms = 0;
+        SCHEDULER_StopTimer(&gScanPauseTimer);
     }
 
     // gScheduleScanListen is always false...
@@ -138,14 +197,14 @@ void CHFRSCANNER_Found(void)
     {
         if (!gScanPauseMode)
         {
-            gScanPauseDelayIn_10ms = scan_pause_delay_in_5_10ms * (gEeprom.SCAN_RESUME_MODE - 1) * 5;
-            gScheduleScanListen    = false;
+            SCHEDULER_StartTimer(&gScanPauseTimer, scan_pause_delay_in_5_10ms * (gEeprom.SCAN_RESUME_MODE - 1) * 5);
+            gScheduleScanListen = false;
             gScanPauseMode         = true;
         }
     }
     else
     {
-        gScanPauseDelayIn_10ms = 0;
+        SCHEDULER_StopTimer(&gScanPauseTimer);
         gScheduleScanListen    = false;
     }
     */
@@ -156,15 +215,15 @@ void CHFRSCANNER_Found(void)
         case SCAN_RESUME_TO:
             if (!gScanPauseMode)
             {
-                gScanPauseDelayIn_10ms = scan_pause_delay_in_1_10ms;
-                gScheduleScanListen    = false;
+                SCHEDULER_StartTimer(&gScanPauseTimer, scan_pause_delay_in_1_10ms);
+                gScheduleScanListen = false;
                 gScanPauseMode         = true;
             }
             break;
 
         case SCAN_RESUME_CO:
         case SCAN_RESUME_SE:
-            gScanPauseDelayIn_10ms = 0;
+            SCHEDULER_StopTimer(&gScanPauseTimer);
             gScheduleScanListen    = false;
             break;
     }
@@ -174,6 +233,13 @@ void CHFRSCANNER_Found(void)
     lastFoundFrqOrChanOld = lastFoundFrqOrChan;
 #endif
 
+    if (gScanFirstHit_10ms == 0) {
+        gScanFirstHit_10ms = MAX(SCHEDULER_GetTicks_10ms() - scanStartTick, 1u);
+#if defined(ENABLE_FEAT_F4HWN_COARSE_SCAN) && defined(ENABLE_FEAT_F4HWN_DEBUG) && defined(ENABLE_UART)
+        LogUartf("SCAN first hit %u ms\r\n", gScanFirstHit_10ms * 10u);
+#endif
+    }
+
     if (IS_MR_CHANNEL(gRxVfo->CHANNEL_SAVE)) { //memory scan
         lastFoundFrqOrChan = gRxVfo->CHANNEL_SAVE;
     }
@@ -183,6 +249,10 @@ void CHFRSCANNER_Found(void)
 
 
     gScanKeepResult = true;
+
+#ifdef ENABLE_FEAT_F4HWN_SCAN_LOG
+    SCANLOG_Begin();
+#endif
 }
 
 void CHFRSCANNER_Stop(void)
@@ -194,6 +264,10 @@ void CHFRSCANNER_Stop(void)
     
     gScanStateDir = SCAN_OFF;
 
+#ifdef ENABLE_FEAT_F4HWN_SCAN_LOG
+    SCANLOG_End();
+#endif
+
     const uint32_t chFr = gScanKeepResult ? lastFoundFrqOrChan : initialFrqOrChan;
     const bool channelChanged = chFr != initialFrqOrChan;
     if (IS_MR_CHANNEL(gNextMrChannel)) {
@@ -224,8 +298,125 @@ void CHFRSCANNER_Stop(void)
     gUpdateDisplay = true;
 }
 
+#ifdef ENABLE_FEAT_F4HWN_COARSE_SCAN
+static void ScanLimits(uint32_t *pLower, uint32_t *pUpper)
+{
+#ifdef ENABLE_SCAN_RANGES
+    if (gScanRangeStart) {
+        *pLower = gScanRangeStart;
+        *pUpper = gScanRangeStop;
+        return;
+    }
+#endif
+    *pLower = frequencyBandTable[gRxVfo->Band].lower;
+    *pUpper = frequencyBandTable[gRxVfo->Band].upper;
+}
+
+static uint16_t MeasureRssi(const uint32_t frequency)
+{
+    BK4819_TuneTo(frequency);
+    SYSTICK_DelayUs(COARSE_SETTLE_US);
+
+    // same glitch based settle wait as the spectrum
+    for (uint8_t i = 0; i < 10 && (BK4819_ReadRegister(0x63) & 0xFF) >= 255; i++)
+        SYSTICK_DelayUs(100);
+
+    return BK4819_GetRSSI();
+}
+
+// fine pass over the StepFrequency bins covered by the coarse bin at 'center'
+static void FineStart(const uint32_t center, const uint32_t lower, const uint32_t upper)
+{
+    fineFreq = FREQUENCY_RoundToStep(center > lower + COARSE_STEP / 2 ? center - COARSE_STEP / 2 : lower, gRxVfo->StepFrequency);
+    fineEnd  = MIN(center + COARSE_STEP / 2, upper);
+    fineBest = FREQUENCY_RoundToStep(center, gRxVfo->StepFrequency);
+    finePeak = 0;
+    scanPass = SCAN_PASS_FINE;
+}
+
+// returns true once every fine bin was measured, the strongest one tuned
+static bool FinePass(void)
+{
+    const uint16_t step = gRxVfo->StepFrequency;
+
+    for (uint8_t i = 0; i < COARSE_BLOCK && fineFreq <= fineEnd; i++, fineFreq += step) {
+        const uint16_t rssi = MeasureRssi(fineFreq);
+        if (rssi > finePeak) {
+            finePeak = rssi;
+            fineBest = fineFreq;
+        }
+    }
+
+    if (fineFreq <= fineEnd)
+        return false;
+
+    gRxVfo->freq_config_RX.Frequency = fineBest;
+    scanPass = SCAN_PASS_CONFIRM;
+    return true;
+}
+
+// returns true when a hit was found and tuned for the squelch to confirm
+static bool CoarsePass(void)
+{
+    uint32_t lower;
+    uint32_t upper;
+    ScanLimits(&lower, &upper);
+
+    const uint32_t step = MAX((uint32_t)gRxVfo->StepFrequency, COARSE_STEP);
+
+    if (scanPass == SCAN_PASS_FINE) {
+        if (FinePass())
+            return true;
+
+        SCHEDULER_StartTimer(&gScanPauseTimer, 1);
+        return false;
+    }
+
+    if (scanPass != SCAN_PASS_COARSE) {
+        // RADIO_SetupRegisters() restored the channel filter and the
+        // interrupts, a squelch opening on a bin must not start a reception
+        BK4819_WriteRegister(BK4819_REG_43, COARSE_BW_REG_43);
+        BK4819_WriteRegister(BK4819_REG_3F, 0);
+        BK4819_WriteRegister(BK4819_REG_02, 0);
+        g_SquelchLost = false;
+        scanPass = SCAN_PASS_COARSE;
+    }
+
+    for (uint8_t i = 0; i < COARSE_BLOCK; i++) {
+        if (gScanStateDir > 0)
+            coarseFreq = (coarseFreq + step > upper) ? lower : coarseFreq + step;
+        else
+            coarseFreq = (coarseFreq < lower + step) ? upper : coarseFreq - step;
+
+        const uint16_t rssi = MeasureRssi(coarseFreq);
+
+        if (noiseFloor == 0)
+            noiseFloor = rssi;
+
+        if (rssi > noiseFloor + COARSE_MARGIN) {
+            FineStart(coarseFreq, lower, upper);
+            break;
+        }
+
+        // slow average, only fed by empty bins
+        noiseFloor = noiseFloor + ((int16_t)(rssi - noiseFloor) / 8);
+    }
+
+    // let the display follow the sweep, on the channel grid
+    gRxVfo->freq_config_RX.Frequency = FREQUENCY_RoundToStep(coarseFreq, gRxVfo->StepFrequency);
+    SCHEDULER_StartTimer(&gScanPauseTimer, 1);
+    gUpdateDisplay = true;
+
+    return false;
+}
+#endif
+
 static void NextFreqChannel(void)
 {
+#ifdef ENABLE_FEAT_F4HWN_COARSE_SCAN
+    if (!CoarsePass())
+        return;
+#else
 #ifdef ENABLE_SCAN_RANGES
     if(gScanRangeStart) {
         gRxVfo->freq_config_RX.Frequency = APP_SetFreqByStepAndLimits(gRxVfo, gScanStateDir, gScanRangeStart, gScanRangeStop);
@@ -233,15 +424,16 @@ static void NextFreqChannel(void)
     else
 #endif
         gRxVfo->freq_config_RX.Frequency = APP_SetFrequencyByStep(gRxVfo, gScanStateDir);
+#endif
 
     RADIO_ApplyOffset(gRxVfo);
     RADIO_ConfigureSquelchAndOutputPower(gRxVfo);
     RADIO_SetupRegisters(true);
 
 #ifdef ENABLE_FASTER_CHANNEL_SCAN
-    gScanPauseDelayIn_10ms = 9;   // 90ms
+    SCHEDULER_StartTimer(&gScanPauseTimer, 9);   // 90ms
 #else
-    gScanPauseDelayIn_10ms = scan_pause_delay_in_6_10ms;
+    SCHEDULER_StartTimer(&gScanPauseTimer, scan_pause_delay_in_6_10ms);
 #endif
 
     gUpdateDisplay     = true;
@@ -358,9 +550,9 @@ static void NextMemChannel(void)
     }
 
 #ifdef ENABLE_FASTER_CHANNEL_SCAN
-    gScanPauseDelayIn_10ms = 9;  // 90ms .. <= ~60ms it misses signals (squelch response and/or PLL lock time) ?
+    SCHEDULER_StartTimer(&gScanPauseTimer, 9);  // 90ms .. <= ~60ms it misses signals (squelch response and/or PLL lock time) ?
 #else
-    gScanPauseDelayIn_10ms = scan_pause_delay_in_3_10ms;
+    SCHEDULER_StartTimer(&gScanPauseTimer, scan_pause_delay_in_3_10ms);
 #endif
 
     if (enabled)
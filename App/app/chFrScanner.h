@@ -15,6 +15,9 @@ extern uint32_t          gScanRangeStart;
 extern uint32_t          gScanRangeStop;
 #endif
 
+// time from scan start to the first signal found, 0 when none yet
+extern uint16_t          gScanFirstHit_10ms;
+
 void CHFRSCANNER_Found(void);
 void CHFRSCANNER_Stop(void);
 void CHFRSCANNER_Start(const bool storeBackupSettings, const int8_t scan_direction);
@@ -28,6 +28,7 @@
 #include "driver/gpio.h"
 #include "functions.h"
 #include "misc.h"
+#include "scheduler.h"
 #include "settings.h"
 #include "ui/inputbox.h"
 #include "ui/ui.h"
@@ -39,7 +40,6 @@
 uint16_t          gFM_Channels[20];
 bool              gFmRadioMode;
 uint8_t           gFmRadioCountdown_500ms;
-volatile uint16_t gFmPlayCountdown_10ms;
 volatile int8_t   gFM_ScanState;
 bool              gFM_AutoScan;
 uint8_t           gFM_ChannelPosition;
@@ -47,6 +47,13 @@ bool              gFM_FoundFrequency;
 bool              gFM_AutoScan;
 uint16_t          gFM_RestoreCountdown_10ms;
 
+static void FmPlayExpired(void)
+{
+    gScheduleFM = true;
+}
+
+SCHEDULER_Timer_t gFmPlayTimer = {.pCallback = FmPlayExpired};
+
 
 
 const uint8_t BUTTON_STATE_PRESSED = 1 << 0;
@@ -134,7 +141,7 @@ void FM_Tune(uint16_t Frequency, int8_t Step, bool bFlag)
 
     gEnableSpeaker = false;
 
-    gFmPlayCountdown_10ms = (gFM_ScanState == FM_SCAN_OFF) ? fm_play_countdown_noscan_10ms : fm_play_countdown_scan_10ms;
+    SCHEDULER_StartTimer(&gFmPlayTimer, (gFM_ScanState == FM_SCAN_OFF) ? fm_play_countdown_noscan_10ms : fm_play_countdown_scan_10ms);
 
     gScheduleFM                 = false;
     gFM_FoundFrequency          = false;
@@ -170,7 +177,7 @@ void FM_PlayAndUpdate(void)
     BK1080_SetFrequency(gEeprom.FM_FrequencyPlaying, gEeprom.FM_Band/*, gEeprom.FM_Space*/);
     SETTINGS_SaveFM();
 
-    gFmPlayCountdown_10ms = 0;
+    SCHEDULER_StopTimer(&gFmPlayTimer);
     gScheduleFM           = false;
     gAskToSave            = false;
 
@@ -585,7 +592,7 @@ void FM_Play(void)
 {
     if (!FM_CheckFrequencyLock(gEeprom.FM_FrequencyPlaying, BK1080_GetFreqLoLimit(gEeprom.FM_Band))) {
         if (!gFM_AutoScan) {
-            gFmPlayCountdown_10ms = 0;
+            SCHEDULER_StopTimer(&gFmPlayTimer);
             gFM_FoundFrequency    = true;
 
             if (!gEeprom.FM_IsMrMode)
@@ -618,6 +625,8 @@ void FM_Play(void)
 
 void FM_Start(void)
 {
+    SETTINGS_LoadFM();
+
     gDualWatchActive          = false;
     gFmRadioMode              = true;
     gFM_ScanState             = FM_SCAN_OFF;
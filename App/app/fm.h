@@ -20,6 +20,7 @@
 #ifdef ENABLE_FMRADIO
 
 #include "driver/keyboard.h"
+#include "scheduler_timer.h"
 
 #define FM_CHANNEL_UP   0x01
 #define FM_CHANNEL_DOWN 0xFF
@@ -31,7 +32,7 @@ enum {
 extern uint16_t          gFM_Channels[20];
 extern bool              gFmRadioMode;
 extern uint8_t           gFmRadioCountdown_500ms;
-extern volatile uint16_t gFmPlayCountdown_10ms;
+extern SCHEDULER_Timer_t gFmPlayTimer;
 extern volatile int8_t   gFM_ScanState;
 extern bool              gFM_AutoScan;
 extern uint8_t           gFM_ChannelPosition;
@@ -42,6 +42,7 @@
 #include "frequencies.h"
 #include "misc.h"
 #include "radio.h"
+#include "scheduler.h"
 #include "settings.h"
 #include "ui/inputbox.h"
 #include "ui/ui.h"
@@ -130,7 +131,7 @@ static void processFKeyFunction(const KEY_Code_t Key, const bool beep)
                 if (gScanStateDir != SCAN_OFF) {
                     if (gCurrentFunction != FUNCTION_INCOMING ||
                         gRxReceptionMode == RX_MODE_NONE      ||
-                        gScanPauseDelayIn_10ms == 0)
+                        !SCHEDULER_IsTimerRunning(&gScanPauseTimer))
                     {   // scan is running (not paused)
                         return;
                     }
@@ -676,7 +677,7 @@ static void MAIN_Key_MENU(bool bKeyPressed, bool bKeyHeld)
             // Exclude work with list 1, 2, 3 or all list
             if(gScanStateDir != SCAN_OFF)
             {
-                if(FUNCTION_IsRx() || gScanPauseDelayIn_10ms > 9)
+                if(FUNCTION_IsRx() || SCHEDULER_GetTimerRemaining(&gScanPauseTimer) > 9)
                 {
                     gMR_ChannelExclude[gTxVfo->CHANNEL_SAVE] = true;
 
@@ -930,7 +931,7 @@ static void MAIN_Key_UP_DOWN(bool bKeyPressed, bool bKeyHeld, int8_t Direction)
 
     // jump to the next channel
     CHFRSCANNER_Start(false, Direction);
-    gScanPauseDelayIn_10ms = 1;
+    SCHEDULER_StartTimer(&gScanPauseTimer, 1);
     gScheduleScanListen = false;
 
     gPttWasReleased = true;
@@ -0,0 +1,165 @@
+/* Copyright 2025 Armel F4HWN
+ * https://github.com/armel
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *     Unless required by applicable law or agreed to in writing, software
+ *     distributed under the License is distributed on an "AS IS" BASIS,
+ *     WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *     See the License for the specific language governing permissions and
+ *     limitations under the License.
+ */
+
+#include "app/nwatch.h"
+#include "misc.h"
+#include "radio.h"
+#include "settings.h"
+
+// Each time squelch opens on a slot its activity grows by NWATCH_ACTIVITY_STEP,
+// and it loses one point every time the ring moves away from it. The dwell on
+// a slot is the normal DW toggle time plus its activity, in 10ms units.
+#define NWATCH_ACTIVITY_STEP 4
+#define NWATCH_ACTIVITY_MAX  16
+
+typedef struct {
+    VFO_Info_t *pVfo;
+    uint8_t     activity;
+} NWatchSlot_t;
+
+// ready to use VFO images of the extra slots, so hopping to them only
+// costs a RADIO_SetupRegisters() and no flash access
+static VFO_Info_t   extraVfo[NWATCH_SLOTS - 2];
+
+static NWatchSlot_t ring[NWATCH_SLOTS];
+static uint8_t      ringCount;
+static uint8_t      ringSlot;
+static uint8_t      ringVisited;
+static bool         ringValid;
+
+static void RebasePointers(VFO_Info_t *pDst, const VFO_Info_t *pSrc)
+{
+    pDst->pRX = (pSrc->pRX == &pSrc->freq_config_TX) ? &pDst->freq_config_TX : &pDst->freq_config_RX;
+    pDst->pTX = (pSrc->pTX == &pSrc->freq_config_RX) ? &pDst->freq_config_RX : &pDst->freq_config_TX;
+}
+
+static void LoadImage(VFO_Info_t *pImage, const uint8_t channel)
+{
+    // borrow the non TX VFO to run the regular channel loader, then give it back
+    const unsigned int vfo     = !gEeprom.TX_VFO;
+    VFO_Info_t        *pVfo    = &gEeprom.VfoInfo[vfo];
+    const VFO_Info_t   backup  = *pVfo;
+    const uint8_t      screen  = gEeprom.ScreenChannel[vfo];
+    const uint8_t      mr      = gEeprom.MrChannel[vfo];
+
+    gEeprom.ScreenChannel[vfo] = channel;
+    RADIO_ConfigureChannel(vfo, VFO_CONFIGURE_RELOAD);
+
+    *pImage = *pVfo;
+    RebasePointers(pImage, pVfo);
+
+    *pVfo                      = backup;
+    gEeprom.ScreenChannel[vfo] = screen;
+    gEeprom.MrChannel[vfo]     = mr;
+}
+
+static void Rebuild(void)
+{
+    ring[0].pVfo     = &gEeprom.VfoInfo[0];
+    ring[0].activity = 0;
+    ring[1].pVfo     = &gEeprom.VfoInfo[1];
+    ring[1].activity = 0;
+    ringCount        = 2;
+
+    if (gEeprom.SCAN_LIST_DEFAULT > 0 && gEeprom.SCAN_LIST_DEFAULT < 4) {
+        const uint8_t list     = gEeprom.SCAN_LIST_DEFAULT - 1;
+        const uint8_t chans[2] = {
+            gEeprom.SCANLIST_PRIORITY_CH1[list],
+            gEeprom.SCANLIST_PRIORITY_CH2[list]
+        };
+
+        for (uint8_t i = 0; i < ARRAY_SIZE(chans); i++) {
+            const uint8_t chan = chans[i];
+
+            if (!RADIO_CheckValidChannel(chan, false, 0))
+                continue;
+
+            // already watched by one of the VFOs or by the other priority slot
+            if (chan == gEeprom.ScreenChannel[0] || chan == gEeprom.ScreenChannel[1])
+                continue;
+            if (i == 1 && ringCount == 3 && chan == chans[0])
+                continue;
+
+            VFO_Info_t *pImage = &extraVfo[ringCount - 2];
+            LoadImage(pImage, chan);
+
+            ring[ringCount].pVfo     = pImage;
+            ring[ringCount].activity = 0;
+            ringCount++;
+        }
+    }
+
+    ringSlot  = gEeprom.RX_VFO;
+    ringValid = true;
+}
+
+void NWATCH_Invalidate(void)
+{
+    ringValid = false;
+}
+
+void NWATCH_Next(void)
+{
+    if (!ringValid)
+        Rebuild();
+
+    // RADIO_SelectVfos() and friends may have moved gRxVfo behind our back
+    if (ring[ringSlot].pVfo != gRxVfo)
+        ringSlot = gEeprom.RX_VFO;
+
+    if (ring[ringSlot].activity > 0)
+        ring[ringSlot].activity--;
+
+    if (++ringSlot >= ringCount)
+        ringSlot = 0;
+
+    ringVisited++;
+
+    // extra slots are heard on the line of the VFO that is not selected for TX:
+    // RX_VFO only names that line, the tuned channel is the one gRxVfo points to
+    gEeprom.RX_VFO = (ringSlot < 2) ? ringSlot : !gEeprom.TX_VFO;
+    gRxVfo         = ring[ringSlot].pVfo;
+}
+
+void NWATCH_MarkActivity(void)
+{
+    NWatchSlot_t *pSlot = &ring[ringSlot];
+
+    if (!ringValid || pSlot->pVfo != gRxVfo)
+        return;
+
+    pSlot->activity = MIN(pSlot->activity + NWATCH_ACTIVITY_STEP, NWATCH_ACTIVITY_MAX);
+}
+
+void NWATCH_BeginPass(void)
+{
+    ringVisited = 0;
+}
+
+bool NWATCH_PassComplete(void)
+{
+    return ringVisited >= ringCount;
+}
+
+bool NWATCH_IsExtraSlot(void)
+{
+    return ringValid && ringSlot >= 2 && ring[ringSlot].pVfo == gRxVfo;
+}
+
+uint16_t NWATCH_GetDwell_10ms(void)
+{
+    return dual_watch_count_toggle_10ms + ring[ringSlot].activity;
+}
@@ -0,0 +1,35 @@
+/* Copyright 2025 Armel F4HWN
+ * https://github.com/armel
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *     Unless required by applicable law or agreed to in writing, software
+ *     distributed under the License is distributed on an "AS IS" BASIS,
+ *     WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *     See the License for the specific language governing permissions and
+ *     limitations under the License.
+ */
+
+#ifndef APP_NWATCH_H
+#define APP_NWATCH_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+// Up to four watched channels: the A/B VFOs plus the two priority
+// channels (PRI1/PRI2) of the default scan list
+#define NWATCH_SLOTS 4
+
+void     NWATCH_Invalidate(void);
+void     NWATCH_Next(void);
+void     NWATCH_MarkActivity(void);
+void     NWATCH_BeginPass(void);
+bool     NWATCH_PassComplete(void);
+bool     NWATCH_IsExtraSlot(void);
+uint16_t NWATCH_GetDwell_10ms(void);
+
+#endif
@@ -0,0 +1,96 @@
+/* Copyright 2025 Armel F4HWN
+ * https://github.com/armel
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *     Unless required by applicable law or agreed to in writing, software
+ *     distributed under the License is distributed on an "AS IS" BASIS,
+ *     WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *     See the License for the specific language governing permissions and
+ *     limitations under the License.
+ */
+
+#include "app/remote.h"
+#include "misc.h"
+#include "scheduler.h"
+
+// A remote key reads as if it was held on the keypad, CheckKeys() debounces
+// it and turns it into press, hold and release events like any other key.
+// Every press comes with a hold time and is released once it runs out, so
+// a host that goes away never leaves a key down or the radio transmitting.
+// The PTT is tracked on its own so that it can be combined with a key.
+
+// shorter presses would not get past the key (20ms) or PTT (30ms) debounce
+#define MIN_HOLD_10MS     5
+// a remote transmission lasts as long as the host keeps renewing it
+#define MAX_PTT_HOLD_10MS 500
+
+REMOTE_KeyTiming_t gRemoteKeyTiming;
+
+static KEY_Code_t key = KEY_INVALID;
+static uint16_t   keyHold_10ms;
+static uint16_t   pttHold_10ms;
+
+bool REMOTE_Key(KEY_Code_t Key, uint16_t Hold_10ms)
+{
+    if (Key >= KEY_INVALID)
+        return false;
+
+    if (Hold_10ms > 0)
+        Hold_10ms = MAX(Hold_10ms, MIN_HOLD_10MS);
+
+    if (Key == KEY_PTT) {
+        pttHold_10ms = MIN(Hold_10ms, (uint16_t)MAX_PTT_HOLD_10MS);
+        return true;
+    }
+
+    // a new press starts a new measurement
+    if (Hold_10ms > 0 && (Key != key || keyHold_10ms == 0)) {
+        gRemoteKeyTiming.Queued_us  = SCHEDULER_GetMicros();
+        gRemoteKeyTiming.Pressed_us = 0;
+        gRemoteKeyTiming.Drawn_us   = 0;
+    }
+
+    key          = Key;
+    keyHold_10ms = Hold_10ms;
+
+    return true;
+}
+
+KEY_Code_t REMOTE_GetKey(void)
+{
+    return (keyHold_10ms > 0) ? key : KEY_INVALID;
+}
+
+bool REMOTE_IsPttPressed(void)
+{
+    return pttHold_10ms > 0;
+}
+
+void REMOTE_TimeSlice10ms(void)
+{
+    if (keyHold_10ms > 0)
+        keyHold_10ms--;
+
+    if (pttHold_10ms > 0)
+        pttHold_10ms--;
+}
+
+void REMOTE_KeyProcessed(KEY_Code_t Key, bool bKeyPressed, bool bKeyHeld)
+{
+    if (Key != key || !bKeyPressed || bKeyHeld)
+        return;
+
+    if (gRemoteKeyTiming.Queued_us != 0 && gRemoteKeyTiming.Pressed_us == 0)
+        gRemoteKeyTiming.Pressed_us = SCHEDULER_GetMicros();
+}
+
+void REMOTE_ScreenUpdated(void)
+{
+    if (gRemoteKeyTiming.Pressed_us != 0 && gRemoteKeyTiming.Drawn_us == 0)
+        gRemoteKeyTiming.Drawn_us = SCHEDULER_GetMicros();
+}
@@ -0,0 +1,42 @@
+/* Copyright 2025 Armel F4HWN
+ * https://github.com/armel
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *     Unless required by applicable law or agreed to in writing, software
+ *     distributed under the License is distributed on an "AS IS" BASIS,
+ *     WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *     See the License for the specific language governing permissions and
+ *     limitations under the License.
+ */
+
+#ifndef APP_REMOTE_H
+#define APP_REMOTE_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "driver/keyboard.h"
+
+// timestamps of the last injected key press, in us since power on, 0 until
+// the step is reached
+typedef struct {
+    uint32_t Queued_us;     // command received
+    uint32_t Pressed_us;    // press event handed to ProcessKey()
+    uint32_t Drawn_us;      // first screen update after it
+} __attribute__((packed)) REMOTE_KeyTiming_t;
+
+extern REMOTE_KeyTiming_t gRemoteKeyTiming;
+
+bool       REMOTE_Key(KEY_Code_t Key, uint16_t Hold_10ms);
+KEY_Code_t REMOTE_GetKey(void);
+bool       REMOTE_IsPttPressed(void);
+void       REMOTE_TimeSlice10ms(void);
+void       REMOTE_KeyProcessed(KEY_Code_t Key, bool bKeyPressed, bool bKeyHeld);
+void       REMOTE_ScreenUpdated(void);
+
+#endif
@@ -0,0 +1,319 @@
+/* Copyright 2025 Armel F4HWN
+ * https://github.com/armel
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *     Unless required by applicable law or agreed to in writing, software
+ *     distributed under the License is distributed on an "AS IS" BASIS,
+ *     WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *     See the License for the specific language governing permissions and
+ *     limitations under the License.
+ */
+
+#include <string.h>
+
+#include "app/chFrScanner.h"
+#include "app/generic.h"
+#include "app/scanlog.h"
+#include "audio.h"
+#include "dcs.h"
+#include "driver/bk4819.h"
+#include "driver/py25q16.h"
+#include "functions.h"
+#include "misc.h"
+#include "radio.h"
+#include "scheduler.h"
+#include "ui/ui.h"
+
+// Records are collected in a RAM ring of a page and programmed a page at a
+// time, each slot being written only once after its sector was erased. The
+// sector the head moves into is erased just before its first page is
+// programmed. Flushing only happens from the 500ms timeslice and never while
+// receiving, as an erase stalls the main loop for tens of ms: once a page
+// worth of records is pending, or once the scan is over. Until then, a new
+// record overwrites the oldest pending one.
+
+#define PAGE_SIZE          0x100
+#define SECTOR_SIZE        PY25Q16_SECTOR_SIZE
+#define RECORDS_PER_PAGE   (PAGE_SIZE / sizeof(ScanLogRecord_t))
+#define RECORDS_PER_SECTOR (SECTOR_SIZE / sizeof(ScanLogRecord_t))
+#define RECORDS_TOTAL      (RECORDS_PER_SECTOR * SCANLOG_SECTORS)
+#define SESSION_EMPTY      0xFFFF
+
+uint16_t gScanLogCursor;
+
+static bool            ready;
+static uint16_t        session;
+static uint16_t        head;            // next free slot in flash
+static uint16_t        stored;          // records in flash
+static ScanLogRecord_t pending[RECORDS_PER_PAGE];    // ring, oldest at pendingFirst
+static uint8_t         pendingFirst;
+static uint8_t         pendingCount;
+
+static ScanLogRecord_t current;
+static bool            recording;
+static uint32_t        beginTick;
+static uint8_t         sampleTick;
+static uint8_t         cssType;         // last CxCSS detector reading
+static uint8_t         cssCode;
+
+static uint32_t SlotAddr(const uint16_t slot)
+{
+    return SCANLOG_ADDR + slot * sizeof(ScanLogRecord_t);
+}
+
+// the session counter wraps, compare it as a serial number
+static bool IsNewer(const ScanLogRecord_t *pA, const ScanLogRecord_t *pB)
+{
+    const int16_t delta = (int16_t)(pA->Session - pB->Session);
+
+    return delta > 0 || (delta == 0 && pA->Time >= pB->Time);
+}
+
+// find the newest record, the head is right after it
+static void Init(void)
+{
+    ScanLogRecord_t newest;
+    int32_t         newestSlot = -1;
+
+    stored = 0;
+
+    // pending is empty at this point, borrow it as the read buffer
+    for (uint16_t slot = 0; slot < RECORDS_TOTAL; slot += RECORDS_PER_PAGE) {
+        PY25Q16_ReadBuffer(SlotAddr(slot), pending, sizeof(pending));
+
+        for (uint8_t i = 0; i < RECORDS_PER_PAGE; i++) {
+            if (pending[i].Session == SESSION_EMPTY)
+                continue;
+
+            stored++;
+
+            if (newestSlot < 0 || IsNewer(&pending[i], &newest)) {
+                newest     = pending[i];
+                newestSlot = slot + i;
+            }
+        }
+    }
+
+    if (newestSlot < 0) {
+        head    = 0;
+        session = 0;
+    }
+    else {
+        head    = (newestSlot + 1) % RECORDS_TOTAL;
+        session = newest.Session + 1;
+        if (session == SESSION_EMPTY)
+            session = 0;
+    }
+
+    pendingFirst = 0;
+    pendingCount = 0;
+    ready        = true;
+}
+
+// free slots left in the flash page the head is in
+static uint8_t PageRoom(void)
+{
+    return RECORDS_PER_PAGE - (head % RECORDS_PER_PAGE);
+}
+
+// program the oldest pending records that fit in the head page
+static void Flush(void)
+{
+    const uint8_t count = MIN(pendingCount, PageRoom());
+
+    if (count == 0)
+        return;
+
+    if (head % RECORDS_PER_SECTOR == 0) {
+        // entering a sector: drop the oldest records it still holds
+        PY25Q16_SectorErase(SlotAddr(head));
+        stored = MIN(stored, (uint16_t)(RECORDS_TOTAL - RECORDS_PER_SECTOR));
+    }
+
+    // the ring may wrap: then two programs into the same page
+    const uint8_t first = MIN(count, (uint8_t)(RECORDS_PER_PAGE - pendingFirst));
+
+    PY25Q16_PageProgram(SlotAddr(head), &pending[pendingFirst], first * sizeof(ScanLogRecord_t));
+    if (count > first)
+        PY25Q16_PageProgram(SlotAddr(head + first), pending, (count - first) * sizeof(ScanLogRecord_t));
+
+    head          = (head + count) % RECORDS_TOTAL;
+    stored       += count;
+    pendingFirst  = (pendingFirst + count) % RECORDS_PER_PAGE;
+    pendingCount -= count;
+}
+
+void SCANLOG_Begin(void)
+{
+    const uint32_t frqOrChan = IS_MR_CHANNEL(gRxVfo->CHANNEL_SAVE) ? gRxVfo->CHANNEL_SAVE : gRxVfo->freq_config_RX.Frequency;
+
+    // the scanner may call CHFRSCANNER_Found() several times for the same hit
+    if (recording && current.FrqOrChan == frqOrChan)
+        return;
+
+    if (recording)
+        SCANLOG_End();
+
+    if (!ready)
+        Init();
+
+    beginTick          = SCHEDULER_GetTicks_10ms();
+    current.Session    = session;
+    current.Time       = beginTick / 100;
+    current.FrqOrChan  = frqOrChan;
+    current.Rssi       = BK4819_GetRSSI();
+    current.CodeType   = CODE_TYPE_OFF;
+    current.Code       = 0;
+    sampleTick         = 0;
+    cssType            = CODE_TYPE_OFF;
+    recording          = true;
+}
+
+void SCANLOG_End(void)
+{
+    if (!recording)
+        return;
+
+    recording        = false;
+    current.Duration = (SCHEDULER_GetTicks_10ms() - beginTick) / 100;
+
+    // called from the scan hop path: only buffer, a full ring loses its oldest
+    if (pendingCount == RECORDS_PER_PAGE) {
+        pendingFirst = (pendingFirst + 1) % RECORDS_PER_PAGE;
+        pendingCount--;
+    }
+
+    pending[(pendingFirst + pendingCount) % RECORDS_PER_PAGE] = current;
+    pendingCount++;
+}
+
+// the CTCSS/DCS the BK4819 detector measures, whatever the channel expects,
+// kept once two samples in a row agree
+static void DetectCss(void)
+{
+    uint32_t cdcssFreq;
+    uint16_t ctcssFreq;
+    uint8_t  type = CODE_TYPE_OFF;
+    uint8_t  code = 0xFF;
+
+    switch (BK4819_GetCxCSSScanResult(&cdcssFreq, &ctcssFreq)) {
+        case BK4819_CSS_RESULT_CDCSS:
+            type = CODE_TYPE_DIGITAL;
+            code = DCS_GetCdcssCode(cdcssFreq);
+            break;
+        case BK4819_CSS_RESULT_CTCSS:
+            type = CODE_TYPE_CONTINUOUS_TONE;
+            code = DCS_GetCtcssCode(ctcssFreq);
+            break;
+        default:
+            break;
+    }
+
+    if (code == 0xFF) {
+        cssType = CODE_TYPE_OFF;
+        return;
+    }
+
+    if (type == cssType && code == cssCode) {
+        current.CodeType = type;
+        current.Code     = code;
+    }
+
+    cssType = type;
+    cssCode = code;
+}
+
+void SCANLOG_TimeSlice10ms(void)
+{
+    if (!recording || !FUNCTION_IsRx())
+        return;
+
+    // peak RSSI and CxCSS detector sampled every 100ms
+    if (++sampleTick >= 10) {
+        sampleTick   = 0;
+        current.Rssi = MAX(current.Rssi, BK4819_GetRSSI());
+
+        if (current.CodeType == CODE_TYPE_OFF)
+            DetectCss();
+    }
+}
+
+void SCANLOG_TimeSlice500ms(void)
+{
+    if (pendingCount == 0)
+        return;
+
+    if (FUNCTION_IsRx())
+        return;
+
+    if (gScanStateDir == SCAN_OFF || pendingCount >= PageRoom())
+        Flush();
+}
+
+uint16_t SCANLOG_GetCount(void)
+{
+    if (!ready)
+        Init();
+
+    return stored + pendingCount;
+}
+
+// index 0 is the newest record
+bool SCANLOG_Read(uint16_t Index, ScanLogRecord_t *pRecord)
+{
+    if (Index >= SCANLOG_GetCount())
+        return false;
+
+    if (Index < pendingCount) {
+        *pRecord = pending[(pendingFirst + pendingCount - 1 - Index) % RECORDS_PER_PAGE];
+        return true;
+    }
+
+    Index -= pendingCount;
+
+    const uint16_t slot = (head + RECORDS_TOTAL - 1 - Index) % RECORDS_TOTAL;
+    PY25Q16_ReadBuffer(SlotAddr(slot), pRecord, sizeof(*pRecord));
+
+    return pRecord->Session != SESSION_EMPTY;
+}
+
+void SCANLOG_ProcessKeys(KEY_Code_t Key, bool bKeyPressed, bool bKeyHeld)
+{
+    if (Key == KEY_PTT) {
+        GENERIC_Key_PTT(bKeyPressed);
+        return;
+    }
+
+    if (!bKeyPressed)
+        return;
+
+    const uint16_t count = SCANLOG_GetCount();
+
+    switch (Key) {
+        case KEY_UP:
+            if (gScanLogCursor > 0)
+                gScanLogCursor--;
+            break;
+        case KEY_DOWN:
+            if (gScanLogCursor + 1 < count)
+                gScanLogCursor++;
+            break;
+        case KEY_EXIT:
+            if (!bKeyHeld) {
+                gBeepToPlay           = BEEP_1KHZ_60MS_OPTIONAL;
+                gRequestDisplayScreen = DISPLAY_MAIN;
+            }
+            return;
+        default:
+            if (!bKeyHeld)
+                gBeepToPlay = BEEP_500HZ_60MS_DOUBLE_BEEP_OPTIONAL;
+            return;
+    }
+
+    gUpdateDisplay = true;
+}
@@ -0,0 +1,57 @@
+/* Copyright 2025 Armel F4HWN
+ * https://github.com/armel
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *     Unless required by applicable law or agreed to in writing, software
+ *     distributed under the License is distributed on an "AS IS" BASIS,
+ *     WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *     See the License for the specific language governing permissions and
+ *     limitations under the License.
+ */
+
+#ifndef APP_SCANLOG_H
+#define APP_SCANLOG_H
+
+#include <assert.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "driver/keyboard.h"
+#include "driver/py25q16.h"
+
+// flash ring, in the free area between calibration and voice prompts
+#define SCANLOG_ADDR    PY25Q16_SCANLOG_ADDR
+#define SCANLOG_SECTORS PY25Q16_SCANLOG_SECTORS
+
+static_assert(SCANLOG_ADDR >= PY25Q16_CALIB_ADDR + PY25Q16_SECTOR_SIZE &&
+              SCANLOG_ADDR + SCANLOG_SECTORS * PY25Q16_SECTOR_SIZE <= PY25Q16_VOICE_ADDR,
+              "the scan log must stay in the free flash area");
+
+typedef struct {
+    uint16_t Session;       // power on counter, 0xFFFF marks an empty slot
+    uint16_t Duration;      // seconds
+    uint32_t Time;          // seconds since power on
+    uint32_t FrqOrChan;     // MR channel number or frequency in 10Hz
+    uint16_t Rssi;          // peak, raw BK4819 units
+    uint8_t  CodeType;      // CTCSS/DCS heard, CODE_TYPE_OFF if none
+    uint8_t  Code;
+} __attribute__((packed)) ScanLogRecord_t;
+
+static_assert(sizeof(ScanLogRecord_t) == 16, "scan log records must tile a flash page");
+
+extern uint16_t gScanLogCursor;
+
+void     SCANLOG_Begin(void);
+void     SCANLOG_End(void);
+void     SCANLOG_TimeSlice10ms(void);
+void     SCANLOG_TimeSlice500ms(void);
+uint16_t SCANLOG_GetCount(void);
+bool     SCANLOG_Read(uint16_t Index, ScanLogRecord_t *pRecord);
+void     SCANLOG_ProcessKeys(KEY_Code_t Key, bool bKeyPressed, bool bKeyHeld);
+
+#endif
@@ -41,6 +41,11 @@ bool              gScanUseCssResult;
 STEP_Setting_t    stepSetting;
 uint8_t           scanHitCount;
 
+// CTCSS measures are in 0.1Hz, two close ones are enough to confirm a tone,
+// loose ones still need three like a plain hit counter would
+#define CTCSS_TIGHT_MATCH      5
+#define CTCSS_CONFIDENCE_FOUND 3
+
 static void SCANNER_Key_DIGITS(KEY_Code_t Key, bool bKeyPressed, bool bKeyHeld)
 {
     if (!bKeyHeld && bKeyPressed)
@@ -462,15 +467,25 @@ void SCANNER_TimeSlice10ms(void)
             else if (scanResult == BK4819_CSS_RESULT_CTCSS) {
                 const uint8_t Code = DCS_GetCtcssCode(ctcssFreq);
                 if (Code != 0xFF) {
-                    if (Code == gScanCssResultCode && gScanCssResultType == CODE_TYPE_CONTINUOUS_TONE) {
-                        if (++scanHitCount >= 2) {
-                            gScanCssState     = SCAN_CSS_STATE_FOUND;
-                            gScanUseCssResult = true;
-                            gUpdateStatus     = true;
-                        }
-                    }
+                    // confidence accumulator: a measure within CTCSS_TIGHT_MATCH
+                    // of the tone is worth two points, any other one point, and
+                    // a different tone starts over from its own sample
+                    int16_t delta = ctcssFreq - CTCSS_Options[Code];
+                    if (delta < 0)
+                        delta = -delta;
+
+                    const uint8_t points = (delta <= CTCSS_TIGHT_MATCH) ? 2 : 1;
+
+                    if (Code == gScanCssResultCode && gScanCssResultType == CODE_TYPE_CONTINUOUS_TONE)
+                        scanHitCount += points;
                     else
-                        scanHitCount = 0;
+                        scanHitCount = points;
+
+                    if (scanHitCount >= CTCSS_CONFIDENCE_FOUND) {
+                        gScanCssState     = SCAN_CSS_STATE_FOUND;
+                        gScanUseCssResult = true;
+                        gUpdateStatus     = true;
+                    }
 
                     gScanCssResultType = CODE_TYPE_CONTINUOUS_TONE;
                     gScanCssResultCode = Code;
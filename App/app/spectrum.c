@@ -352,11 +352,7 @@ static void SetF(uint32_t f)
 {
     fMeasure = f;
 
-    BK4819_SetFrequency(fMeasure);
-    BK4819_PickRXFilterPathBasedOnFrequency(fMeasure);
-    uint16_t reg = BK4819_ReadRegister(BK4819_REG_30);
-    BK4819_WriteRegister(BK4819_REG_30, 0);
-    BK4819_WriteRegister(BK4819_REG_30, reg);
+    BK4819_TuneTo(fMeasure);
 }
 
 // Spectrum related
@@ -0,0 +1,170 @@
+/* Copyright 2025 Armel F4HWN
+ * https://github.com/armel
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *     Unless required by applicable law or agreed to in writing, software
+ *     distributed under the License is distributed on an "AS IS" BASIS,
+ *     WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *     See the License for the specific language governing permissions and
+ *     limitations under the License.
+ */
+
+#include <string.h>
+
+#ifdef ENABLE_AM_FIX
+    #include "am_fix.h"
+#endif
+#include "app/telemetry.h"
+#include "app/uart.h"
+#include "driver/bk4819.h"
+#include "functions.h"
+#include "helper/battery.h"
+#include "misc.h"
+#include "radio.h"
+#include "scheduler.h"
+
+// A subscribed host gets a 0x062A message every period: a fixed header,
+// then the selected fields in TELEMETRY_Field_t order. Samples that find
+// the port busy are dropped and counted, the stream never waits.
+
+static const uint8_t fieldSize[TELEMETRY_FIELD_COUNT] = {
+    [TELEMETRY_RSSI]      = 2,
+    [TELEMETRY_NOISE]     = 1,
+    [TELEMETRY_GLITCH]    = 1,
+    [TELEMETRY_AGC]       = 2,
+    [TELEMETRY_RX_GAIN]   = 1,
+    [TELEMETRY_AM_FIX]    = 1,
+    [TELEMETRY_SQUELCH]   = 1,
+    [TELEMETRY_FUNCTION]  = 1,
+    [TELEMETRY_BATTERY]   = 2,
+    [TELEMETRY_FREQUENCY] = 4,
+};
+
+typedef struct {
+    uint16_t ID;
+    uint16_t Size;
+    uint16_t Seq;
+    uint16_t Dropped;
+    uint32_t Tick_10ms;
+    uint32_t Fields;
+    uint8_t  Data[16];      // room for all the fields
+} __attribute__((packed)) Record_t;
+
+static uint32_t port;
+static uint32_t fields;
+static uint16_t period_10ms;
+static uint16_t countdown;
+static uint16_t seq;
+static uint16_t dropped;
+
+static uint8_t *Put(uint8_t *pOut, const void *pValue, const uint8_t Size)
+{
+    memcpy(pOut, pValue, Size);
+    return pOut + Size;
+}
+
+static uint8_t *Sample(uint8_t *pOut, const TELEMETRY_Field_t Field)
+{
+    switch (Field) {
+        case TELEMETRY_RSSI: {
+            const uint16_t rssi = BK4819_GetRSSI();
+            return Put(pOut, &rssi, sizeof(rssi));
+        }
+        case TELEMETRY_NOISE:
+            *pOut = BK4819_GetExNoiceIndicator();
+            break;
+        case TELEMETRY_GLITCH:
+            *pOut = BK4819_GetGlitchIndicator();
+            break;
+        case TELEMETRY_AGC: {
+            const uint16_t agc = BK4819_ReadRegister(BK4819_REG_7E);
+            return Put(pOut, &agc, sizeof(agc));
+        }
+        case TELEMETRY_RX_GAIN:
+            *pOut = BK4819_GetRxGain_dB();
+            break;
+        case TELEMETRY_AM_FIX:
+#ifdef ENABLE_AM_FIX
+            *pOut = AM_fix_get_gain_diff();
+#else
+            *pOut = 0;
+#endif
+            break;
+        case TELEMETRY_SQUELCH:
+            *pOut = g_SquelchLost;
+            break;
+        case TELEMETRY_FUNCTION:
+            *pOut = gCurrentFunction;
+            break;
+        case TELEMETRY_BATTERY:
+            return Put(pOut, &gBatteryVoltageAverage, sizeof(gBatteryVoltageAverage));
+        case TELEMETRY_FREQUENCY:
+            return Put(pOut, &gRxVfo->freq_config_RX.Frequency, sizeof(uint32_t));
+        default:
+            return pOut;
+    }
+
+    return pOut + 1;
+}
+
+// returns the size of the samples, 0 when the stream is stopped
+uint16_t TELEMETRY_Subscribe(uint32_t Port, uint32_t Fields, uint16_t Period_10ms)
+{
+    port        = Port;
+    fields      = Fields & TELEMETRY_ALL_FIELDS;
+    period_10ms = (fields != 0) ? Period_10ms : 0;
+    countdown   = 0;
+    seq         = 0;
+    dropped     = 0;
+
+    if (period_10ms == 0)
+        return 0;
+
+    uint16_t size = 0;
+    for (uint8_t i = 0; i < TELEMETRY_FIELD_COUNT; i++) {
+        if (fields & (1u << i))
+            size += fieldSize[i];
+    }
+
+    return size;
+}
+
+void TELEMETRY_TimeSlice10ms(void)
+{
+    if (period_10ms == 0)
+        return;
+
+    if (countdown > 0) {
+        countdown--;
+        return;
+    }
+
+    countdown = period_10ms - 1;
+
+    Record_t record;
+    uint8_t *pOut = record.Data;
+
+    for (uint8_t i = 0; i < TELEMETRY_FIELD_COUNT; i++) {
+        if (fields & (1u << i))
+            pOut = Sample(pOut, i);
+    }
+
+    // keep the message size even, like the other replies
+    if ((pOut - record.Data) & 1)
+        *pOut++ = 0;
+
+    record.ID        = 0x062A;
+    record.Size      = pOut - (uint8_t *)&record.Seq;
+    record.Seq       = seq++;
+    record.Dropped   = dropped;
+    record.Tick_10ms = SCHEDULER_GetTicks_10ms();
+    record.Fields    = fields;
+
+    if (!UART_SendNotification(port, &record, pOut - (uint8_t *)&record))
+        dropped++;
+}
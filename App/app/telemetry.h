@@ -0,0 +1,43 @@
+/* Copyright 2025 Armel F4HWN
+ * https://github.com/armel
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *     Unless required by applicable law or agreed to in writing, software
+ *     distributed under the License is distributed on an "AS IS" BASIS,
+ *     WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *     See the License for the specific language governing permissions and
+ *     limitations under the License.
+ */
+
+#ifndef APP_TELEMETRY_H
+#define APP_TELEMETRY_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+// sample fields, sent in this order and with these sizes when selected
+typedef enum {
+    TELEMETRY_RSSI,         // uint16_t, BK4819 raw, 0.5dB units
+    TELEMETRY_NOISE,        // uint8_t,  BK4819 ex-noise indicator
+    TELEMETRY_GLITCH,       // uint8_t,  BK4819 glitch indicator
+    TELEMETRY_AGC,          // uint16_t, BK4819 REG_7E (AGC enable, gain index, strength)
+    TELEMETRY_RX_GAIN,      // int8_t,   front end gain in dB
+    TELEMETRY_AM_FIX,       // int8_t,   AM fix gain correction in dB, 0 without AM fix
+    TELEMETRY_SQUELCH,      // uint8_t,  1 when the squelch is open
+    TELEMETRY_FUNCTION,     // uint8_t,  FUNCTION_Type_t
+    TELEMETRY_BATTERY,      // uint16_t, 10mV units
+    TELEMETRY_FREQUENCY,    // uint32_t, RX frequency in 10Hz units
+    TELEMETRY_FIELD_COUNT
+} TELEMETRY_Field_t;
+
+#define TELEMETRY_ALL_FIELDS ((1u << TELEMETRY_FIELD_COUNT) - 1)
+
+uint16_t TELEMETRY_Subscribe(uint32_t Port, uint32_t Fields, uint16_t Period_10ms);
+void     TELEMETRY_TimeSlice10ms(void);
+
+#endif
@@ -23,6 +23,28 @@
 #ifdef ENABLE_FMRADIO
     #include "app/fm.h"
 #endif
+#ifdef ENABLE_FEAT_F4HWN_SCAN_LOG
+    #include "app/scanlog.h"
+#endif
+#ifdef ENABLE_FEAT_F4HWN_RX_LATENCY
+    #include "app/app.h"
+#endif
+#if defined(ENABLE_FEAT_F4HWN_PROFILER) || defined(ENABLE_FEAT_F4HWN_DEADLINE)
+    #include "profiler.h"
+#endif
+#ifdef ENABLE_FEAT_F4HWN_ADAPTIVE_SAVE
+    #include "helper/dutycycle.h"
+#endif
+#ifdef ENABLE_FEAT_F4HWN_SCREENSHOT
+    #include "screenshot.h"
+#endif
+#ifdef ENABLE_FEAT_F4HWN_REMOTE_KEYS
+    #include "app/remote.h"
+#endif
+#ifdef ENABLE_FEAT_F4HWN_TELEMETRY
+    #include "app/telemetry.h"
+#endif
+#include "app/chFrScanner.h"
 #include "app/uart.h"
 #include "board.h"
 #include "py32f071_ll_dma.h"
@@ -31,6 +53,7 @@
 #include "driver/crc.h"
 #include "driver/eeprom.h"
 #include "driver/gpio.h"
+#include "driver/py25q16.h"
 
 #if defined(ENABLE_UART)
 #include "driver/uart.h"
@@ -42,6 +65,7 @@
 
 #include "functions.h"
 #include "misc.h"
+#include "scheduler.h"
 #include "settings.h"
 #include "version.h"
 
@@ -57,7 +81,8 @@
     #define DMA_CHANNEL LL_DMA_CHANNEL_2
 #endif
 
-// !! Make sure this is correct!
+// !! Make sure this is correct! Largest reply (header included), on every
+// port, tagged or not
 #define MAX_REPLY_SIZE 144
 
 typedef struct {
@@ -191,25 +216,73 @@ typedef union
 #define bIsEncrypted true
 
 #ifdef ENABLE_USB
+// Replies are appended to a batch, sent with a single bulk-in transfer
+// once the commands of an APP_Update() pass are handled, which fills
+// whole 64 byte USB packets. While a batch is on the wire the other one
+// is being filled.
+#define VCP_BATCH_SIZE    320
+#define VCP_FLUSH_TIMEOUT 100000    // us, the host stopped reading
+
+static uint8_t  VCP_Batch[2][VCP_BATCH_SIZE] __attribute__ ((aligned (4)));
+static uint8_t  VCP_BatchFill;
+static uint16_t VCP_BatchLen;
+
+// never waits: false while the previous batch is still on the wire
+static bool VCP_Flush(void)
+{
+    static uint32_t BusySince;
+
+    if (VCP_BatchLen == 0)
+        return true;
+
+    if (cdc_acm_data_send_busy())
+    {
+        const uint32_t Now = SCHEDULER_GetMicros();
+
+        if (BusySince == 0)
+        {
+            BusySince = Now | 1;
+            return false;
+        }
+
+        if (Now - BusySince <= VCP_FLUSH_TIMEOUT)
+            return false;
+
+        // the host stopped reading, drop the batch rather than stall
+        BusySince    = 0;
+        VCP_BatchLen = 0;
+        return true;
+    }
+
+    BusySince = 0;
+
+    VCP_SendAsync(VCP_Batch[VCP_BatchFill], VCP_BatchLen);
+
+    VCP_BatchFill ^= 1;
+    VCP_BatchLen   = 0;
+
+    return true;
+}
+
 static void SendReply_VCP(void *pReply, uint16_t Size)
 {
-    static uint8_t VCP_ReplyBuf[MAX_REPLY_SIZE + sizeof(Header_t) + sizeof(Footer_t)];
+    const uint16_t FrameSize = sizeof(Header_t) + Size + sizeof(Footer_t);
 
-    // !!
-    if (Size > MAX_REPLY_SIZE)
+    // commands are only taken once VCP_HasRoom(), this is for notifications
+    if (VCP_BatchLen + FrameSize > VCP_BATCH_SIZE && !VCP_Flush())
     {
         return;
     }
 
-    memcpy(VCP_ReplyBuf + sizeof(Header_t), pReply, Size);
+    uint8_t  *pFrame  = VCP_Batch[VCP_BatchFill] + VCP_BatchLen;
+    Header_t *pHeader = (Header_t *)pFrame;
+    Footer_t *pFooter = (Footer_t *)(pFrame + sizeof(Header_t) + Size);
+    uint8_t  *pBytes  = pFrame + sizeof(Header_t);
 
-    Header_t *pHeader = (Header_t *)VCP_ReplyBuf;
-    Footer_t *pFooter = (Footer_t *)(VCP_ReplyBuf + sizeof(Header_t) + Size);
-    pReply = VCP_ReplyBuf + sizeof(Header_t);
+    memcpy(pBytes, pReply, Size);
 
     if (bIsEncrypted)
     {
-        uint8_t     *pBytes = (uint8_t *)pReply;
         unsigned int i;
         for (i = 0; i < Size; i++)
             pBytes[i] ^= Obfuscation[i % 16];
@@ -218,9 +291,6 @@ static void SendReply_VCP(void *pReply, uint16_t Size)
     pHeader->ID = 0xCDAB;
     pHeader->Size = Size;
 
-    // VCP_Send((uint8_t *)&Header, sizeof(Header));
-    // VCP_Send(pReply, Size);
-   
     if (bIsEncrypted)
     {
         pFooter->Padding[0] = Obfuscation[(Size + 0) % 16] ^ 0xFF;
@@ -233,14 +303,55 @@ static void SendReply_VCP(void *pReply, uint16_t Size)
     }
     pFooter->ID = 0xBADC;
 
-    // VCP_Send((uint8_t *)&Footer, sizeof(Footer));
-
-    VCP_SendAsync(VCP_ReplyBuf, sizeof(Header_t) + Size + sizeof(Footer_t));
+    VCP_BatchLen += FrameSize;
 }
 #endif // ENABLE_USB
 
+// Tagged commands (0x0530) wrap another command along with a sequence
+// number, its reply comes back wrapped in a 0x0531 with the same number.
+// Hosts can then keep several commands in flight and match the replies.
+typedef struct {
+    Header_t Header;
+    uint16_t Seq;
+    uint16_t Padding;
+} Tag_t;
+
+static int32_t ReplySeq = -1;      // tag of the command being handled
+
+#ifdef ENABLE_USB
+#define VCP_MAX_FRAME (sizeof(Header_t) + sizeof(Tag_t) + MAX_REPLY_SIZE + sizeof(Footer_t))
+
+_Static_assert(VCP_BATCH_SIZE >= VCP_MAX_FRAME, "a VCP batch must hold the largest reply");
+
+// a command is only taken when its reply is sure to fit in the batch,
+// otherwise it waits in the RX buffer for the next poll
+static bool VCP_HasRoom(void)
+{
+    return VCP_BatchLen + VCP_MAX_FRAME <= VCP_BATCH_SIZE || VCP_Flush();
+}
+#endif
+
 static void SendReply(uint32_t Port, void *pReply, uint16_t Size)
 {
+    // one limit for every path, a reply that works untagged works tagged
+    if (Size > MAX_REPLY_SIZE)
+        return;
+
+    if (ReplySeq >= 0)
+    {
+        static uint8_t Tagged[sizeof(Tag_t) + MAX_REPLY_SIZE] __attribute__ ((aligned (4)));
+        Tag_t *pTag = (Tag_t *)Tagged;
+
+        pTag->Header.ID   = 0x0531;
+        pTag->Header.Size = sizeof(Tag_t) - sizeof(Header_t) + Size;
+        pTag->Seq         = ReplySeq;
+        pTag->Padding     = 0;
+        memcpy(Tagged + sizeof(Tag_t), pReply, Size);
+
+        pReply = Tagged;
+        Size  += sizeof(Tag_t);
+    }
+
 #if defined(ENABLE_USB)
     if (Port == UART_PORT_VCP)
     {
@@ -346,7 +457,7 @@ static void CMD_0514(uint32_t Port, const uint8_t *pBuffer)
     gFmRadioCountdown_500ms = fm_radio_countdown_500ms;
 #endif
 
-    gSerialConfigCountDown_500ms = 12; // 6 sec
+    SCHEDULER_StartTimer(&gSerialConfigTimer, 600); // 6 sec
     
     // turn the LCD backlight off
     BACKLIGHT_TurnOff();
@@ -384,7 +495,7 @@ static void CMD_051B(uint32_t Port, const uint8_t *pBuffer)
     if (pCmd->Timestamp != Timestamp)
         return;
 
-    gSerialConfigCountDown_500ms = 12; // 6 sec
+    SCHEDULER_StartTimer(&gSerialConfigTimer, 600); // 6 sec
 
     #ifdef ENABLE_FMRADIO
         gFmRadioCountdown_500ms = fm_radio_countdown_500ms;
@@ -438,7 +549,7 @@ static void CMD_051D(uint32_t Port, const uint8_t *pBuffer)
     if (pCmd->Timestamp != Timestamp)
         return;
 
-    gSerialConfigCountDown_500ms = 12; // 6 sec
+    SCHEDULER_StartTimer(&gSerialConfigTimer, 600); // 6 sec
     
     bReloadEeprom = false;
 
@@ -454,7 +565,11 @@ static void CMD_051D(uint32_t Port, const uint8_t *pBuffer)
 
     if (!bIsLocked)
     {
+        // runs of writable blocks go down in one go, a sector is then
+        // erased once per command rather than once per block
         unsigned int i;
+        unsigned int RunStart = 0;
+        unsigned int RunSize  = 0;
         for (i = 0; i < (pCmd->Size / 8); i++)
         {
             const uint16_t Offset = pCmd->Offset + (i * 8U);
@@ -465,10 +580,20 @@ static void CMD_051D(uint32_t Port, const uint8_t *pBuffer)
 
             if ((Offset < 0x0E98 || Offset >= 0x0EA0) || !bIsInLockScreen || pCmd->bAllowPassword)
             {    
-                EEPROM_WriteBuffer(Offset, &pCmd->Data[i * 8U]);
+                if (RunSize == 0)
+                    RunStart = i * 8U;
+                RunSize += 8;
+            }
+            else if (RunSize > 0)
+            {
+                EEPROM_WriteBlock(pCmd->Offset + RunStart, &pCmd->Data[RunStart], RunSize);
+                RunSize = 0;
             }
         }
 
+        if (RunSize > 0)
+            EEPROM_WriteBlock(pCmd->Offset + RunStart, &pCmd->Data[RunStart], RunSize);
+
         if (bReloadEeprom)
             SETTINGS_InitEEPROM();
     }
@@ -577,7 +702,7 @@ static void CMD_052F(uint32_t Port, const uint8_t *pBuffer)
     if (gCurrentFunction == FUNCTION_POWER_SAVE)
         FUNCTION_Select(FUNCTION_FOREGROUND);
 
-    gSerialConfigCountDown_500ms = 12; // 6 sec
+    SCHEDULER_StartTimer(&gSerialConfigTimer, 600); // 6 sec
 
     if(0) {}
 #if defined(ENABLE_UART)
@@ -638,6 +763,524 @@ static void CMD_0602_WriteBK4819Reg(const uint8_t *pBuffer)
 }
 #endif
 
+#ifdef ENABLE_FEAT_F4HWN_SCAN_LOG
+// read the scan activity log, index 0 is the newest record
+static void CMD_0610_ReadScanLog(uint32_t Port, const uint8_t *pBuffer)
+{
+    typedef struct __attribute__((__packed__)) {
+        Header_t header;
+        uint16_t index;
+        uint8_t  count;
+    } CMD_0610_t;
+
+    const CMD_0610_t *cmd = (const CMD_0610_t *) pBuffer;
+
+    struct __attribute__((__packed__)) {
+        Header_t header;
+        struct __attribute__((__packed__)) {
+            uint16_t        index;
+            uint16_t        total;
+            uint8_t         count;
+            uint8_t         padding[3];
+            ScanLogRecord_t records[8];
+        } data;
+    } reply;
+
+    const uint8_t count = MIN(cmd->count, ARRAY_SIZE(reply.data.records));
+    uint8_t       n     = 0;
+
+    while (n < count && SCANLOG_Read(cmd->index + n, &reply.data.records[n]))
+        n++;
+
+    reply.header.ID    = 0x0611;
+    reply.header.Size  = sizeof(reply.data) - sizeof(reply.data.records) + n * sizeof(ScanLogRecord_t);
+    reply.data.index   = cmd->index;
+    reply.data.total   = SCANLOG_GetCount();
+    reply.data.count   = n;
+    memset(reply.data.padding, 0, sizeof(reply.data.padding));
+    SendReply(Port, &reply, sizeof(reply.header) + reply.header.Size);
+}
+#endif
+
+#ifdef ENABLE_FEAT_F4HWN_WFI
+// idle and busy 10ms ticks since power on, a proxy of the current draw
+static void CMD_0612_ReadIdleStats(uint32_t Port)
+{
+    struct __attribute__((__packed__)) {
+        Header_t header;
+        struct __attribute__((__packed__)) {
+            uint32_t idle;
+            uint32_t busy;
+        } data;
+    } reply;
+
+    reply.header.ID   = 0x0613;
+    reply.header.Size = sizeof(reply.data);
+    reply.data.idle   = SCHEDULER_GetIdleTicks();
+    reply.data.busy   = SCHEDULER_GetBusyTicks();
+    SendReply(Port, &reply, sizeof(reply));
+}
+#endif
+
+#ifdef ENABLE_FEAT_F4HWN_RX_LATENCY
+// squelch open to audio on latency, last and worst since power on
+static void CMD_0614_ReadRxLatency(uint32_t Port)
+{
+    struct __attribute__((__packed__)) {
+        Header_t        header;
+        APP_RxLatency_t data;
+    } reply;
+
+    reply.header.ID   = 0x0615;
+    reply.header.Size = sizeof(reply.data);
+    reply.data        = gRxLatency;
+    SendReply(Port, &reply, sizeof(reply));
+}
+#endif
+
+#ifdef ENABLE_FEAT_F4HWN_PROFILER
+#define PROFILER_PAGE_SECTIONS 8
+
+// per subsystem cycle counts, PROFILER_PAGE_SECTIONS from index first per
+// request, optionally all cleared once read
+static void CMD_0616_ReadProfiler(uint32_t Port, const uint8_t *pBuffer)
+{
+    typedef struct __attribute__((__packed__)) {
+        Header_t header;
+        uint8_t  reset;
+        uint8_t  first;
+    } CMD_0616_t;
+
+    const CMD_0616_t *cmd = (const CMD_0616_t *) pBuffer;
+
+    struct __attribute__((__packed__)) {
+        Header_t header;
+        struct __attribute__((__packed__)) {
+            uint32_t         ticks;
+            uint8_t          total;
+            uint8_t          first;
+            uint8_t          count;
+            uint8_t          padding;
+            PROFILER_Entry_t entries[PROFILER_PAGE_SECTIONS];
+        } data;
+    } reply;
+
+    _Static_assert(sizeof(reply) <= MAX_REPLY_SIZE, "profiler page too large");
+
+    const uint8_t first = MIN(cmd->first, (uint8_t)PROFILER_SECTION_COUNT);
+    const uint8_t count = MIN(PROFILER_SECTION_COUNT - first, PROFILER_PAGE_SECTIONS);
+
+    reply.header.ID    = 0x0617;
+    reply.header.Size  = 8 + count * sizeof(PROFILER_Entry_t);
+    reply.data.ticks   = SCHEDULER_GetTicks_10ms();
+    reply.data.total   = PROFILER_SECTION_COUNT;
+    reply.data.first   = first;
+    reply.data.count   = count;
+    reply.data.padding = 0;
+    memcpy(reply.data.entries, &gProfiler[first], count * sizeof(PROFILER_Entry_t));
+
+    if (cmd->reset)
+        PROFILER_Reset();
+
+    SendReply(Port, &reply, sizeof(reply.header) + reply.header.Size);
+}
+#endif
+
+#ifdef ENABLE_FEAT_F4HWN_DEADLINE
+// lost 10ms slices since power on and the longest runs of them
+static void CMD_0618_ReadDeadlineMisses(uint32_t Port, const uint8_t *pBuffer)
+{
+    typedef struct __attribute__((__packed__)) {
+        Header_t header;
+        uint8_t  reset;
+    } CMD_0618_t;
+
+    const CMD_0618_t *cmd = (const CMD_0618_t *) pBuffer;
+
+    struct __attribute__((__packed__)) {
+        Header_t header;
+        struct __attribute__((__packed__)) {
+            uint32_t        misses;
+            uint8_t         count;
+            uint8_t         padding[3];
+            PROFILER_Miss_t worst[PROFILER_WORST_COUNT];
+        } data;
+    } reply;
+
+    reply.header.ID   = 0x0619;
+    reply.header.Size = sizeof(reply.data);
+    reply.data.misses = gDeadlineMisses;
+    reply.data.count  = PROFILER_WORST_COUNT;
+    memset(reply.data.padding, 0, sizeof(reply.data.padding));
+    memcpy(reply.data.worst, gDeadlineWorst, sizeof(reply.data.worst));
+
+    if (cmd->reset)
+        PROFILER_ResetDeadline();
+
+    SendReply(Port, &reply, sizeof(reply));
+}
+#endif
+
+#ifdef ENABLE_FEAT_F4HWN_STOP
+// STOP mode count, time spent there and wake up to RX latency
+static void CMD_061A_ReadStopStats(uint32_t Port)
+{
+    struct __attribute__((__packed__)) {
+        Header_t              header;
+        SCHEDULER_StopStats_t data;
+    } reply;
+
+    reply.header.ID   = 0x061B;
+    reply.header.Size = sizeof(reply.data);
+    reply.data        = gStopStats;
+    SendReply(Port, &reply, sizeof(reply));
+}
+#endif
+
+#ifdef ENABLE_FEAT_F4HWN_ADAPTIVE_SAVE
+#define DUTYCYCLE_PAGE_HOURS 12
+
+// power save activity per hour of uptime, the last day, DUTYCYCLE_PAGE_HOURS
+// ring slots from index first per request
+static void CMD_061C_ReadDutyCycle(uint32_t Port, const uint8_t *pBuffer)
+{
+    typedef struct __attribute__((__packed__)) {
+        Header_t header;
+        uint8_t  first;
+        uint8_t  padding[3];
+    } CMD_061C_t;
+
+    const CMD_061C_t *cmd = (const CMD_061C_t *) pBuffer;
+
+    struct __attribute__((__packed__)) {
+        Header_t header;
+        struct __attribute__((__packed__)) {
+            uint8_t          current;
+            uint8_t          total;
+            uint8_t          first;
+            uint8_t          count;
+            DUTYCYCLE_Hour_t hours[DUTYCYCLE_PAGE_HOURS];
+        } data;
+    } reply;
+
+    _Static_assert(sizeof(reply) <= MAX_REPLY_SIZE, "duty cycle page too large");
+
+    const uint8_t first = MIN(cmd->first, (uint8_t)DUTYCYCLE_HOURS);
+    const uint8_t count = MIN(DUTYCYCLE_HOURS - first, DUTYCYCLE_PAGE_HOURS);
+
+    reply.header.ID    = 0x061D;
+    reply.header.Size  = 4 + count * sizeof(DUTYCYCLE_Hour_t);
+    reply.data.current = DUTYCYCLE_GetCurrentHour();
+    reply.data.total   = DUTYCYCLE_HOURS;
+    reply.data.first   = first;
+    reply.data.count   = count;
+    memcpy(reply.data.hours, &gDutyCycleHours[first], count * sizeof(DUTYCYCLE_Hour_t));
+    SendReply(Port, &reply, sizeof(reply.header) + reply.header.Size);
+}
+#endif
+
+// time from reset to the radio tuned, then to the main loop running
+static void CMD_061E_ReadBootTime(uint32_t Port)
+{
+    struct __attribute__((__packed__)) {
+        Header_t header;
+        struct __attribute__((__packed__)) {
+            uint32_t rxOn_us;
+            uint32_t ready_us;
+        } data;
+    } reply;
+
+    reply.header.ID     = 0x061F;
+    reply.header.Size   = sizeof(reply.data);
+    reply.data.rxOn_us  = gBootRxOn_us;
+    reply.data.ready_us = gBootReady_us;
+    SendReply(Port, &reply, sizeof(reply));
+}
+
+#ifdef ENABLE_FEAT_F4HWN_FLASH_CACHE
+// SPI flash read cache hit rate, optionally cleared once read
+static void CMD_0620_ReadFlashCache(uint32_t Port, const uint8_t *pBuffer)
+{
+    typedef struct __attribute__((__packed__)) {
+        Header_t header;
+        uint8_t  reset;
+    } CMD_0620_t;
+
+    const CMD_0620_t *cmd = (const CMD_0620_t *) pBuffer;
+
+    struct __attribute__((__packed__)) {
+        Header_t             header;
+        PY25Q16_CacheStats_t data;
+    } reply;
+
+    reply.header.ID   = 0x0621;
+    reply.header.Size = sizeof(reply.data);
+    reply.data        = gFlashCacheStats;
+
+    if (cmd->reset)
+        PY25Q16_ResetCacheStats();
+
+    SendReply(Port, &reply, sizeof(reply));
+}
+#endif
+
+#ifdef ENABLE_FEAT_F4HWN_SCREENSHOT
+// screenshot viewer keepalive, keyframe acknowledge or request. No reply,
+// the frames are streamed to the port this came from.
+static void CMD_0622_ScreenShotControl(uint32_t Port, const uint8_t *pBuffer)
+{
+    typedef struct __attribute__((__packed__)) {
+        Header_t header;
+        uint8_t  type;
+        uint8_t  value;
+        uint16_t padding;
+    } CMD_0622_t;
+
+    const CMD_0622_t *cmd = (const CMD_0622_t *) pBuffer;
+
+    SCREENSHOT_HostMessage(Port, cmd->type, cmd->value);
+}
+#endif
+
+#ifdef ENABLE_FEAT_F4HWN_REMOTE_KEYS
+// press a key (KEY_Code_t, KEY_PTT included) for hold x 10ms, hold 0
+// releases it. Sent again before the hold runs out, the key stays down.
+// The PTT hold is capped to 5s, and nothing is pressed on a locked radio.
+static void CMD_0624_InjectKey(uint32_t Port, const uint8_t *pBuffer)
+{
+    typedef struct __attribute__((__packed__)) {
+        Header_t header;
+        uint8_t  key;
+        uint8_t  padding;
+        uint16_t hold_10ms;
+    } CMD_0624_t;
+
+    const CMD_0624_t *cmd = (const CMD_0624_t *) pBuffer;
+
+    struct __attribute__((__packed__)) {
+        Header_t header;
+        struct __attribute__((__packed__)) {
+            uint32_t time_us;
+            uint8_t  accepted;
+            uint8_t  padding[3];
+        } data;
+    } reply;
+
+    reply.header.ID     = 0x0625;
+    reply.header.Size   = sizeof(reply.data);
+    reply.data.accepted = !(bHasCustomAesKey && gIsLocked) && REMOTE_Key(cmd->key, cmd->hold_10ms);
+    reply.data.time_us  = SCHEDULER_GetMicros();
+    memset(reply.data.padding, 0, sizeof(reply.data.padding));
+    SendReply(Port, &reply, sizeof(reply));
+}
+
+// when the last injected press was received, handled and first drawn
+static void CMD_0626_ReadKeyTiming(uint32_t Port)
+{
+    struct __attribute__((__packed__)) {
+        Header_t           header;
+        REMOTE_KeyTiming_t data;
+    } reply;
+
+    reply.header.ID   = 0x0627;
+    reply.header.Size = sizeof(reply.data);
+    reply.data        = gRemoteKeyTiming;
+    SendReply(Port, &reply, sizeof(reply));
+}
+#endif
+
+#ifdef ENABLE_FEAT_F4HWN_TELEMETRY
+// stream the selected TELEMETRY_Field_t every period x 10ms to this port,
+// as 0x062A messages. A period or a field mask of 0 stops it.
+static void CMD_0628_SubscribeTelemetry(uint32_t Port, const uint8_t *pBuffer)
+{
+    typedef struct __attribute__((__packed__)) {
+        Header_t header;
+        uint32_t fields;
+        uint16_t period_10ms;
+        uint16_t padding;
+    } CMD_0628_t;
+
+    const CMD_0628_t *cmd = (const CMD_0628_t *) pBuffer;
+
+    struct __attribute__((__packed__)) {
+        Header_t header;
+        struct __attribute__((__packed__)) {
+            uint32_t fields;
+            uint16_t sampleSize;
+            uint16_t padding;
+        } data;
+    } reply;
+
+    reply.header.ID       = 0x0629;
+    reply.header.Size     = sizeof(reply.data);
+    reply.data.sampleSize = TELEMETRY_Subscribe(Port, cmd->fields, cmd->period_10ms);
+    reply.data.fields     = reply.data.sampleSize ? (cmd->fields & TELEMETRY_ALL_FIELDS) : 0;
+    reply.data.padding    = 0;
+    SendReply(Port, &reply, sizeof(reply));
+}
+#endif
+
+// application area of the internal flash, after the bootloader (py32f071xb.ld)
+#define FIRMWARE_ADDR      0x08002800
+#define FIRMWARE_SIZE      (118 * 1024)
+#define FIRMWARE_CRC_CHUNK 0x1000   // ~4ms of CRC_Update per request
+
+// CRC16 (as CRC_Calculate) of a slice of the running firmware, chained from
+// crc so the host can check a whole image in steps. A slice out of the
+// application area is answered with size 0.
+static void CMD_062C_ReadFirmwareCrc(uint32_t Port, const uint8_t *pBuffer)
+{
+    typedef struct __attribute__((__packed__)) {
+        Header_t header;
+        uint32_t offset;
+        uint16_t size;
+        uint16_t crc;
+    } CMD_062C_t;
+
+    const CMD_062C_t *cmd = (const CMD_062C_t *) pBuffer;
+
+    struct __attribute__((__packed__)) {
+        Header_t header;
+        struct __attribute__((__packed__)) {
+            uint32_t offset;
+            uint16_t size;
+            uint16_t crc;
+        } data;
+    } reply;
+
+    uint16_t size = cmd->size;
+    uint16_t crc  = cmd->crc;
+
+    if (size > FIRMWARE_CRC_CHUNK || cmd->offset > FIRMWARE_SIZE || size > FIRMWARE_SIZE - cmd->offset)
+        size = 0;
+
+    const uint8_t *pData = (const uint8_t *)(FIRMWARE_ADDR + cmd->offset);
+
+    for (uint16_t i = 0; i < size; i++)
+        crc = CRC_Update(crc, pData[i]);
+
+    reply.header.ID   = 0x062D;
+    reply.header.Size = sizeof(reply.data);
+    reply.data.offset = cmd->offset;
+    reply.data.size   = size;
+    reply.data.crc    = crc;
+    SendReply(Port, &reply, sizeof(reply));
+}
+
+#define EEPROM_CRC_BLOCKS 32
+#define EEPROM_CRC_BYTES  0x2000  // whole EEPROM at most, ~15ms
+
+// CRC16 (as CRC_Calculate) of count blocks of blockSize bytes from offset,
+// for the host to find which blocks differ from its copy. Same session and
+// lock rules as 0x051B, a request it cannot answer gets count 0.
+static void CMD_062E_ReadEepromCrc(uint32_t Port, const uint8_t *pBuffer)
+{
+    typedef struct __attribute__((__packed__)) {
+        Header_t header;
+        uint16_t offset;
+        uint16_t blockSize;
+        uint8_t  count;
+        uint8_t  padding[3];
+        uint32_t timestamp;
+    } CMD_062E_t;
+
+    const CMD_062E_t *cmd = (const CMD_062E_t *) pBuffer;
+
+    struct __attribute__((__packed__)) {
+        Header_t header;
+        struct __attribute__((__packed__)) {
+            uint16_t offset;
+            uint16_t blockSize;
+            uint8_t  count;
+            uint8_t  padding[3];
+            uint16_t crc[EEPROM_CRC_BLOCKS];
+        } data;
+    } reply;
+
+    uint32_t Timestamp = 0;
+
+    if(0) {}
+#if defined(ENABLE_UART)
+    else if (Port == UART_PORT_UART)
+    {
+        Timestamp = UART_Timestamp;
+    }
+#endif
+#if defined(ENABLE_USB)
+    else if (Port == UART_PORT_VCP)
+    {
+        Timestamp = VCP_Timestamp;
+    }
+#endif
+    else
+    {
+        return;
+    }
+
+    if (cmd->timestamp != Timestamp)
+        return;
+
+    SCHEDULER_StartTimer(&gSerialConfigTimer, 600); // 6 sec
+
+    const uint32_t total = (uint32_t)cmd->blockSize * cmd->count;
+    uint8_t        count = cmd->count;
+
+    if (count > EEPROM_CRC_BLOCKS || cmd->blockSize == 0 || total > EEPROM_CRC_BYTES || cmd->offset + total > 0x2000)
+        count = 0;
+
+    if (bHasCustomAesKey && gIsLocked)
+        count = 0;
+
+    for (uint8_t i = 0; i < count; i++) {
+        uint16_t address = cmd->offset + i * cmd->blockSize;
+        uint16_t left    = cmd->blockSize;
+        uint16_t crc     = 0;
+
+        while (left > 0) {
+            uint8_t       chunk[64];
+            const uint8_t n = MIN(left, sizeof(chunk));
+
+            EEPROM_ReadBuffer(address, chunk, n);
+            for (uint8_t j = 0; j < n; j++)
+                crc = CRC_Update(crc, chunk[j]);
+
+            address += n;
+            left    -= n;
+        }
+
+        reply.data.crc[i] = crc;
+    }
+
+    reply.header.ID      = 0x062F;
+    reply.header.Size    = 8 + count * sizeof(reply.data.crc[0]);
+    reply.data.offset    = cmd->offset;
+    reply.data.blockSize = cmd->blockSize;
+    reply.data.count     = count;
+    memset(reply.data.padding, 0, sizeof(reply.data.padding));
+    SendReply(Port, &reply, sizeof(reply.header) + reply.header.Size);
+}
+
+// time from the start of the last scan to its first signal, 0 when none yet
+static void CMD_0630_ReadScanFirstHit(uint32_t Port)
+{
+    struct __attribute__((__packed__)) {
+        Header_t header;
+        struct __attribute__((__packed__)) {
+            uint32_t firstHit_ms;
+            uint8_t  scanning;
+            uint8_t  padding[3];
+        } data;
+    } reply;
+
+    reply.header.ID        = 0x0631;
+    reply.header.Size      = sizeof(reply.data);
+    reply.data.firstHit_ms = gScanFirstHit_10ms * 10u;
+    reply.data.scanning    = gScanStateDir != SCAN_OFF;
+    memset(reply.data.padding, 0, sizeof(reply.data.padding));
+    SendReply(Port, &reply, sizeof(reply));
+}
+
 bool UART_IsCommandAvailable(uint32_t Port)
 {
     uint16_t Index;
@@ -665,6 +1308,9 @@ bool UART_IsCommandAvailable(uint32_t Port)
 #if defined(ENABLE_USB)
     else if (Port == UART_PORT_VCP)
     {
+        if (!VCP_HasRoom())
+            return false;
+
         DmaLength = VCP_RxBufPointer;
         ReadBuf = VCP_RxBuf;
         ReadBufSize = sizeof(VCP_RxBuf);
@@ -723,26 +1369,6 @@ bool UART_IsCommandAvailable(uint32_t Port)
         return false;
     }
 
-    if (TailIndex < Index)
-    {
-        const uint16_t ChunkSize = ReadBufSize - Index;
-        memcpy(pUART_Command->Buffer, ReadBuf + Index, ChunkSize);
-        memcpy(pUART_Command->Buffer + ChunkSize, ReadBuf, TailIndex);
-    }
-    else
-        memcpy(pUART_Command->Buffer, ReadBuf + Index, TailIndex - Index);
-
-    TailIndex = DMA_INDEX(TailIndex, 2, ReadBufSize);
-    if (TailIndex < (*pReadPointer))
-    {
-        memset(ReadBuf + (*pReadPointer), 0, ReadBufSize - (*pReadPointer));
-        memset(ReadBuf, 0, TailIndex);
-    }
-    else
-        memset(ReadBuf + (*pReadPointer), 0, TailIndex - (*pReadPointer));
-
-    *pReadPointer = TailIndex;
-
     /* --
     if (pUART_Command->Header.ID == 0x0514)
         bIsEncrypted = false;
@@ -751,16 +1377,35 @@ bool UART_IsCommandAvailable(uint32_t Port)
         bIsEncrypted = true;
     -- */
 
-    if (bIsEncrypted)
+    // A single pass over the ring copies the payload and its CRC out,
+    // de-obfuscates them and runs the CRC. Consumed bytes are cleared so
+    // that they are never matched again.
+    const uint8_t Mask = bIsEncrypted ? 0xFF : 0x00;
+    uint8_t      *pOut = pUART_Command->Buffer;
+
+    for (uint16_t i = 0; i < 4; i++)
+        ReadBuf[DMA_INDEX(*pReadPointer, i, ReadBufSize)] = 0;
+
+    Crc = 0;
+    for (uint16_t i = 0; i < Size + 2u; i++)
     {
-        unsigned int i;
-        for (i = 0; i < (Size + 2u); i++)
-            pUART_Command->Buffer[i] ^= Obfuscation[i % 16];
+        const uint8_t Byte = ReadBuf[Index] ^ (Obfuscation[i & 15] & Mask);
+
+        ReadBuf[Index] = 0;
+        if (++Index == ReadBufSize)
+            Index = 0;
+
+        pOut[i] = Byte;
+        if (i < Size)
+            Crc = CRC_Update(Crc, Byte);
     }
 
-    Crc = pUART_Command->Buffer[Size] | (pUART_Command->Buffer[Size + 1] << 8);
+    ReadBuf[TailIndex] = 0;
+    ReadBuf[DMA_INDEX(TailIndex, 1, ReadBufSize)] = 0;
 
-    return CRC_Calculate(pUART_Command->Buffer, Size) == Crc;
+    *pReadPointer = DMA_INDEX(TailIndex, 2, ReadBufSize);
+
+    return Crc == (pOut[Size] | (pOut[Size + 1] << 8));
 }
 
 void UART_HandleCommand(uint32_t Port)
@@ -785,6 +1430,19 @@ void UART_HandleCommand(uint32_t Port)
         return;
     }
 
+    ReplySeq = -1;
+
+    if (pUART_Command->Header.ID == 0x0530)
+    {
+        const Tag_t *pTag = (const Tag_t *)pUART_Command->Buffer;
+
+        if (pTag->Header.Size < sizeof(Tag_t))   // seq, padding and an inner header
+            return;
+
+        ReplySeq = pTag->Seq;
+        memmove(pUART_Command->Buffer, pUART_Command->Buffer + sizeof(Tag_t), pTag->Header.Size - (sizeof(Tag_t) - sizeof(Header_t)));
+    }
+
     switch (pUART_Command->Header.ID)
     {
         case 0x0514:
@@ -842,9 +1500,145 @@ void UART_HandleCommand(uint32_t Port)
             CMD_0602_WriteBK4819Reg(pUART_Command->Buffer);
             break;
 #endif
+
+#ifdef ENABLE_FEAT_F4HWN_SCAN_LOG
+        case 0x0610:
+            CMD_0610_ReadScanLog(Port, pUART_Command->Buffer);
+            break;
+#endif
+
+#ifdef ENABLE_FEAT_F4HWN_WFI
+        case 0x0612:
+            CMD_0612_ReadIdleStats(Port);
+            break;
+#endif
+
+#ifdef ENABLE_FEAT_F4HWN_RX_LATENCY
+        case 0x0614:
+            CMD_0614_ReadRxLatency(Port);
+            break;
+#endif
+
+#ifdef ENABLE_FEAT_F4HWN_PROFILER
+        case 0x0616:
+            CMD_0616_ReadProfiler(Port, pUART_Command->Buffer);
+            break;
+#endif
+
+#ifdef ENABLE_FEAT_F4HWN_DEADLINE
+        case 0x0618:
+            CMD_0618_ReadDeadlineMisses(Port, pUART_Command->Buffer);
+            break;
+#endif
+
+#ifdef ENABLE_FEAT_F4HWN_STOP
+        case 0x061A:
+            CMD_061A_ReadStopStats(Port);
+            break;
+#endif
+
+#ifdef ENABLE_FEAT_F4HWN_ADAPTIVE_SAVE
+        case 0x061C:
+            CMD_061C_ReadDutyCycle(Port, pUART_Command->Buffer);
+            break;
+#endif
+
+        case 0x061E:
+            CMD_061E_ReadBootTime(Port);
+            break;
+
+#ifdef ENABLE_FEAT_F4HWN_FLASH_CACHE
+        case 0x0620:
+            CMD_0620_ReadFlashCache(Port, pUART_Command->Buffer);
+            break;
+#endif
+
+#ifdef ENABLE_FEAT_F4HWN_SCREENSHOT
+        case 0x0622:
+            CMD_0622_ScreenShotControl(Port, pUART_Command->Buffer);
+            break;
+#endif
+
+#ifdef ENABLE_FEAT_F4HWN_REMOTE_KEYS
+        case 0x0624:
+            CMD_0624_InjectKey(Port, pUART_Command->Buffer);
+            break;
+
+        case 0x0626:
+            CMD_0626_ReadKeyTiming(Port);
+            break;
+#endif
+
+#ifdef ENABLE_FEAT_F4HWN_TELEMETRY
+        case 0x0628:
+            CMD_0628_SubscribeTelemetry(Port, pUART_Command->Buffer);
+            break;
+#endif
+
+        case 0x062C:
+            CMD_062C_ReadFirmwareCrc(Port, pUART_Command->Buffer);
+            break;
+
+        case 0x062E:
+            CMD_062E_ReadEepromCrc(Port, pUART_Command->Buffer);
+            break;
+
+        case 0x0630:
+            CMD_0630_ReadScanFirstHit(Port);
+            break;
     } // switch
 
+    ReplySeq = -1;
+
     #ifdef ENABLE_FEAT_F4HWN_SCREENSHOT
-        gUART_LockScreenshot = 20; // lock screenshot
+        // remote operation goes along with the screen stream
+        switch (pUART_Command->Header.ID) {
+            case 0x0622:
+            case 0x0624:
+            case 0x0626:
+                break;
+            default:
+                gUART_LockScreenshot = 20; // lock screenshot
+        }
     #endif
 }
+
+// unsolicited message (header included), dropped rather than waited for
+// when the port has no room for it
+bool UART_SendNotification(uint32_t Port, void *pMessage, uint16_t Size)
+{
+#if defined(ENABLE_USB)
+    if (Port == UART_PORT_VCP)
+    {
+        if (VCP_BatchLen + sizeof(Header_t) + Size + sizeof(Footer_t) > VCP_BATCH_SIZE && !VCP_Flush())
+            return false;
+
+        SendReply(Port, pMessage, Size);
+        return true;
+    }
+#endif
+#if defined(ENABLE_UART)
+    if (Port == UART_PORT_UART)
+    {
+        if (UART_GetTxFree() < sizeof(Header_t) + Size + sizeof(Footer_t))
+            return false;
+
+        SendReply(Port, pMessage, Size);
+        return true;
+    }
+#endif
+
+    return false;
+}
+
+void UART_FlushReplies(uint32_t Port)
+{
+#if defined(ENABLE_USB)
+    if (Port == UART_PORT_VCP)
+    {
+        VCP_Flush();
+    }
+#else
+    UNUSED(Port);
+#endif
+}
@@ -19,6 +19,7 @@
 #define APP_UART_H
 
 #include <stdbool.h>
+#include <stdint.h>
 
 enum
 {
@@ -30,8 +31,13 @@ enum
 #endif
 };
 
+// commands a host may have in flight on the VCP, handled in one pass
+#define UART_VCP_PIPELINE_DEPTH 4
+
 bool UART_IsCommandAvailable(uint32_t Port);
 void UART_HandleCommand(uint32_t Port);
+void UART_FlushReplies(uint32_t Port);
+bool UART_SendNotification(uint32_t Port, void *pMessage, uint16_t Size);
 
 #endif
 
@@ -31,156 +31,139 @@
 #include "functions.h"
 #include "misc.h"
 #include "settings.h"
+#include "task.h"
 #include "ui/ui.h"
 
 
 BEEP_Type_t gBeepToPlay = BEEP_NONE;
 
-void AUDIO_PlayBeep(BEEP_Type_t Beep)
-{
-
-    if (Beep != BEEP_880HZ_60MS_DOUBLE_BEEP &&
-        Beep != BEEP_500HZ_60MS_DOUBLE_BEEP &&
-        Beep != BEEP_440HZ_500MS &&
-#ifdef ENABLE_DTMF_CALLING
-        Beep != BEEP_880HZ_200MS &&
-        Beep != BEEP_880HZ_500MS &&
-#endif
-#ifdef ENABLE_FEAT_F4HWN
-        Beep != BEEP_400HZ_30MS &&
-        Beep != BEEP_500HZ_30MS &&
-        Beep != BEEP_600HZ_30MS &&
-#endif
-       !gEeprom.BEEP_CONTROL)
-        return;
+static struct {
+    TASK_t      Task;
+    BEEP_Type_t Beep;
+    uint16_t    ToneConfig;
+    uint16_t    Duration;
+    uint8_t     Pulses;     // 60ms pulses before the final tone
+} beep;
 
-#ifdef ENABLE_AIRCOPY
-    if (gScreenToDisplay == DISPLAY_AIRCOPY)
-        return;
-#endif
-
-    if (gCurrentFunction == FUNCTION_RECEIVE)
-        return;
-
-    if (gCurrentFunction == FUNCTION_MONITOR)
-        return;
-
-#ifdef ENABLE_FMRADIO
-    if (gFmRadioMode)
-        BK1080_Mute(true);
-#endif
-
-    AUDIO_AudioPathOff();
-
-    if (gCurrentFunction == FUNCTION_POWER_SAVE && gRxIdleMode)
-        BK4819_RX_TurnOn();
-
-    SYSTEM_DelayMs(20);
-
-    uint16_t ToneConfig = BK4819_ReadRegister(BK4819_REG_71);
-
-    uint16_t ToneFrequency;
+static uint16_t BeepFrequency(BEEP_Type_t Beep)
+{
     switch (Beep)
     {
         default:
         case BEEP_NONE:
-            ToneFrequency = 220;
-            break;
+            return 220;
         case BEEP_1KHZ_60MS_OPTIONAL:
-            ToneFrequency = 1000;
-            break;
+            return 1000;
         case BEEP_500HZ_60MS_DOUBLE_BEEP_OPTIONAL:
         case BEEP_500HZ_60MS_DOUBLE_BEEP:
-            ToneFrequency = 500;
-            break;
+            return 500;
         case BEEP_440HZ_500MS:
-            ToneFrequency = 440;
-            break;
+            return 440;
         case BEEP_880HZ_60MS_DOUBLE_BEEP:
 #ifndef ENABLE_FEAT_F4HWN
         case BEEP_880HZ_200MS:
         case BEEP_880HZ_500MS:
 #endif
-            ToneFrequency = 880;
-            break;
+            return 880;
 #ifdef ENABLE_FEAT_F4HWN
         case BEEP_400HZ_30MS:
-            ToneFrequency = 400;
-            break;
+            return 400;
         case BEEP_500HZ_30MS:
-            ToneFrequency = 500;
-            break;
+            return 500;
         case BEEP_600HZ_30MS:
-            ToneFrequency = 600;
-            break;
+            return 600;
 #endif
     }
+}
 
-    if(Beep == BEEP_400HZ_30MS || Beep == BEEP_500HZ_30MS || Beep == BEEP_600HZ_30MS)
-    {
-        BK4819_WriteRegister(BK4819_REG_70, BK4819_REG_70_ENABLE_TONE1 | ((1 & 0x7f) << BK4819_REG_70_SHIFT_TONE1_TUNING_GAIN));
-    }
-
-    BK4819_PlayTone(ToneFrequency, true);
-
-    SYSTEM_DelayMs(2);
-
-    AUDIO_AudioPathOn();
-
-    SYSTEM_DelayMs(60);
+static void BeepShape(BEEP_Type_t Beep)
+{
+    beep.Pulses = 0;
 
-    uint16_t Duration;
     switch (Beep)
     {
         case BEEP_880HZ_60MS_DOUBLE_BEEP:
-            BK4819_ExitTxMute();
-            SYSTEM_DelayMs(60);
-            BK4819_EnterTxMute();
-            SYSTEM_DelayMs(20);
-            [[fallthrough]];
+            beep.Pulses = 2;
+            beep.Duration = 60;
+            break;
         case BEEP_500HZ_60MS_DOUBLE_BEEP_OPTIONAL:
         case BEEP_500HZ_60MS_DOUBLE_BEEP:
-            BK4819_ExitTxMute();
-            SYSTEM_DelayMs(60);
-            BK4819_EnterTxMute();
-            SYSTEM_DelayMs(20);
-            [[fallthrough]];
+            beep.Pulses = 1;
+            beep.Duration = 60;
+            break;
         case BEEP_1KHZ_60MS_OPTIONAL:
-            BK4819_ExitTxMute();
-            Duration = 60;
+            beep.Duration = 60;
             break;
 #ifdef ENABLE_FEAT_F4HWN
         case BEEP_400HZ_30MS:
         case BEEP_500HZ_30MS:
         case BEEP_600HZ_30MS:
-            BK4819_ExitTxMute();
-            Duration = 30;
+            beep.Duration = 30;
             break;
 #endif
         case BEEP_440HZ_500MS:
 #ifndef ENABLE_FEAT_F4HWN
         case BEEP_880HZ_200MS:
-            BK4819_ExitTxMute();
-            Duration = 200;
+            beep.Duration = 200;
             break;
         case BEEP_880HZ_500MS:
 #endif
         default:
-            BK4819_ExitTxMute();
-            Duration = 500;
+            beep.Duration = 500;
             break;
     }
+}
+
+static TASK_State_t BeepTask(TASK_t *pTask)
+{
+    TASK_BEGIN(pTask);
+
+#ifdef ENABLE_FMRADIO
+    if (gFmRadioMode)
+        BK1080_Mute(true);
+#endif
+
+    AUDIO_AudioPathOff();
+
+    if (gCurrentFunction == FUNCTION_POWER_SAVE && gRxIdleMode)
+        BK4819_RX_TurnOn();
+
+    TASK_DELAY_MS(pTask, 20);
+
+    beep.ToneConfig = BK4819_ReadRegister(BK4819_REG_71);
+
+    if(beep.Beep == BEEP_400HZ_30MS || beep.Beep == BEEP_500HZ_30MS || beep.Beep == BEEP_600HZ_30MS)
+    {
+        BK4819_WriteRegister(BK4819_REG_70, BK4819_REG_70_ENABLE_TONE1 | ((1 & 0x7f) << BK4819_REG_70_SHIFT_TONE1_TUNING_GAIN));
+    }
+
+    BK4819_PlayTone(BeepFrequency(beep.Beep), true);
+
+    TASK_DELAY_MS(pTask, 2);
+
+    AUDIO_AudioPathOn();
+
+    TASK_DELAY_MS(pTask, 60);
+
+    while (beep.Pulses > 0) {
+        BK4819_ExitTxMute();
+        TASK_DELAY_MS(pTask, 60);
+        BK4819_EnterTxMute();
+        TASK_DELAY_MS(pTask, 20);
+        beep.Pulses--;
+    }
 
-    SYSTEM_DelayMs(Duration);
+    BK4819_ExitTxMute();
+    TASK_DELAY_MS(pTask, beep.Duration);
     BK4819_EnterTxMute();
-    SYSTEM_DelayMs(20);
+    TASK_DELAY_MS(pTask, 20);
 
     AUDIO_AudioPathOff();
 
-    SYSTEM_DelayMs(5);
+    TASK_DELAY_MS(pTask, 5);
     BK4819_TurnsOffTones_TurnsOnRX();
-    SYSTEM_DelayMs(5);
-    BK4819_WriteRegister(BK4819_REG_71, ToneConfig);
+    TASK_DELAY_MS(pTask, 5);
+    BK4819_WriteRegister(BK4819_REG_71, beep.ToneConfig);
 
     if (gEnableSpeaker)
         AUDIO_AudioPathOn();
@@ -197,6 +180,68 @@ void AUDIO_PlayBeep(BEEP_Type_t Beep)
     gVoxResumeCountdown = 80;
 #endif
 
+    TASK_END(pTask);
+}
+
+// starts the beep and returns at its first wait, AUDIO_RunBeep() takes it
+// from there on every main loop pass
+void AUDIO_StartBeep(BEEP_Type_t Beep)
+{
+    AUDIO_CompleteBeep();
+
+    if (Beep != BEEP_880HZ_60MS_DOUBLE_BEEP &&
+        Beep != BEEP_500HZ_60MS_DOUBLE_BEEP &&
+        Beep != BEEP_440HZ_500MS &&
+#ifdef ENABLE_DTMF_CALLING
+        Beep != BEEP_880HZ_200MS &&
+        Beep != BEEP_880HZ_500MS &&
+#endif
+#ifdef ENABLE_FEAT_F4HWN
+        Beep != BEEP_400HZ_30MS &&
+        Beep != BEEP_500HZ_30MS &&
+        Beep != BEEP_600HZ_30MS &&
+#endif
+       !gEeprom.BEEP_CONTROL)
+        return;
+
+#ifdef ENABLE_AIRCOPY
+    if (gScreenToDisplay == DISPLAY_AIRCOPY)
+        return;
+#endif
+
+    if (gCurrentFunction == FUNCTION_RECEIVE)
+        return;
+
+    if (gCurrentFunction == FUNCTION_MONITOR)
+        return;
+
+    beep.Beep = Beep;
+    BeepShape(Beep);
+    TASK_Start(&beep.Task);
+    BeepTask(&beep.Task);
+}
+
+void AUDIO_RunBeep(void)
+{
+    if (TASK_IsRunning(&beep.Task))
+        BeepTask(&beep.Task);
+}
+
+void AUDIO_CompleteBeep(void)
+{
+    while (TASK_IsRunning(&beep.Task))
+        BeepTask(&beep.Task);
+}
+
+bool AUDIO_IsBeepPlaying(void)
+{
+    return TASK_IsRunning(&beep.Task);
+}
+
+void AUDIO_PlayBeep(BEEP_Type_t Beep)
+{
+    AUDIO_StartBeep(Beep);
+    AUDIO_CompleteBeep();
 }
 
 #ifdef ENABLE_VOICE
@@ -209,8 +254,14 @@ uint8_t gVoiceBufLen = 0;
 VOICE_ID_t        gVoiceID[8];
 uint8_t           gVoiceReadIndex;
 uint8_t           gVoiceWriteIndex;
-volatile uint16_t gCountdownToPlayNextVoice_10ms;
 volatile bool     gFlagPlayQueuedVoice;
+
+static void PlayNextVoice(void)
+{
+    gFlagPlayQueuedVoice = true;
+}
+
+SCHEDULER_Timer_t gPlayNextVoiceTimer = {.pCallback = PlayNextVoice};
 VOICE_ID_t        gAnotherVoiceID = VOICE_ID_INVALID;
 
 static const uint16_t VOICE_SAMPLES[256] = 
@@ -382,8 +433,8 @@ void AUDIO_PlaySingleVoice(bool bFlag)
         }
 
         gVoiceReadIndex                = 1;
-        gCountdownToPlayNextVoice_10ms = Delay;
         gFlagPlayQueuedVoice           = false;
+        SCHEDULER_StartTimer(&gPlayNextVoiceTimer, Delay);
 
         return;
     }
@@ -488,8 +539,8 @@ void AUDIO_PlayQueuedVoice(void)
 
             AUDIO_PlayVoice(VoiceID);
 
-            gCountdownToPlayNextVoice_10ms = Delay;
             gFlagPlayQueuedVoice           = false;
+            SCHEDULER_StartTimer(&gPlayNextVoiceTimer, Delay);
 
             #ifdef ENABLE_VOX
                 gVoxResumeCountdown = 2000;
@@ -21,6 +21,7 @@
 #include <stdint.h>
 
 #include "driver/gpio.h"
+#include "scheduler.h"
 
 enum BEEP_Type_t
 {
@@ -46,6 +47,10 @@ typedef enum BEEP_Type_t BEEP_Type_t;
 extern BEEP_Type_t       gBeepToPlay;
 
 void AUDIO_PlayBeep(BEEP_Type_t Beep);
+void AUDIO_StartBeep(BEEP_Type_t Beep);
+void AUDIO_RunBeep(void);
+void AUDIO_CompleteBeep(void);
+bool AUDIO_IsBeepPlaying(void);
 
 #define AUDIO_AudioPathOn() GPIO_EnableAudioPath()
 
@@ -145,7 +150,7 @@ void AUDIO_PlayBeep(BEEP_Type_t Beep);
     extern VOICE_ID_t        gVoiceID[8];
     extern uint8_t           gVoiceReadIndex;
     extern uint8_t           gVoiceWriteIndex;
-    extern volatile uint16_t gCountdownToPlayNextVoice_10ms;
+    extern SCHEDULER_Timer_t gPlayNextVoiceTimer;
     extern volatile bool     gFlagPlayQueuedVoice;
     extern VOICE_ID_t        gAnotherVoiceID;
     
@@ -66,26 +66,63 @@ uint32_t DCS_GetGolayCodeWord(DCS_CodeType_t CodeType, uint8_t Option)
     return Code;
 }
 
+// One bit per 9 bit code present in DCS_Options, and the number of codes
+// below each 32 bit word: the option index of an octal code is a popcount
+// away, instead of a walk through the whole table.
+static const uint32_t DCS_Bitmap[16] = {
+    0x46680000, 0x1E201A88, 0x16247000, 0x14246428,
+    0x00680420, 0x126A2678, 0x06202240, 0x02304248,
+    0x06080E00, 0x00743460, 0x04484048, 0x00200040,
+    0x06900440, 0x00141000, 0x16080408, 0x00001008
+};
+
+static const uint8_t DCS_Rank[16] = {
+     0,   6,  16,  24,  33,  38,  51,  57,
+    64,  70,  79,  85,  87,  93,  96, 102
+};
+
+static uint8_t DCS_GetOption(uint32_t Code)
+{
+    const uint32_t Word = DCS_Bitmap[Code >> 5];
+    const uint32_t Bit  = 1U << (Code & 31U);
+
+    if (!(Word & Bit))
+        return 0xFF;
+
+    return DCS_Rank[Code >> 5] + __builtin_popcount(Word & (Bit - 1U));
+}
+
 uint8_t DCS_GetCdcssCode(uint32_t Code)
 {
-    unsigned int i;
-    for (i = 0; i < 23; i++)
+    unsigned int i = 0;
+
+    // The scan result is 24 bits wide. Like the code word walk always did,
+    // a 24th bit is folded into bit 22 by the first rotation, which is
+    // then spent.
+    if (Code & 0x800000U)
     {
-        uint32_t Shift;
+        Code = (Code >> 1) | ((Code & 1U) << 22);
+        i    = 1;
+    }
+
+    // The Golay (23,12) code is cyclic: if the received word is not a valid
+    // code word as is, none of its rotations is either, and if it is, every
+    // rotation whose data bits carry the 0b100 marker and a known code is
+    // the encoding of that code. One check up front then replaces a full
+    // encode per candidate.
+    if (DCS_CalculateGolay(Code & 0xFFFU) != Code)
+        return 0xFF;
 
+    for (; i < 23; i++)
+    {
         if (((Code >> 9) & 0x7U) == 4)
         {
-            unsigned int j;
-            for (j = 0; j < ARRAY_SIZE(DCS_Options); j++)
-                if (DCS_Options[j] == (Code & 0x1FF))
-                    if (DCS_GetGolayCodeWord(2, j) == Code)
-                        return j;
+            const uint8_t Option = DCS_GetOption(Code & 0x1FFU);
+            if (Option != 0xFF)
+                return Option;
         }
 
-        Shift = Code >> 1;
-        if (Code & 1U)
-            Shift |= 0x400000U;
-        Code = Shift;
+        Code = (Code >> 1) | ((Code & 1U) << 22);
     }
 
     return 0xFF;
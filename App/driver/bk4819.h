@@ -85,6 +85,7 @@ void     BK4819_EnableVox(uint16_t Vox1Threshold, uint16_t Vox0Threshold);
 void     BK4819_SetFilterBandwidth(const BK4819_FilterBandwidth_t Bandwidth, const bool weak_no_different);
 void     BK4819_SetupPowerAmplifier(const uint8_t bias, const uint32_t frequency);
 void     BK4819_SetFrequency(uint32_t Frequency);
+void     BK4819_TuneTo(uint32_t Frequency);
 void     BK4819_SetupSquelch(
             uint8_t SquelchOpenRSSIThresh,
             uint8_t SquelchCloseRSSIThresh,
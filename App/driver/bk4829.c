@@ -762,6 +762,18 @@ void BK4819_SetFrequency(uint32_t Frequency)
     BK4819_WriteRegister(BK4819_REG_39, (Frequency >> 16) & 0xFFFF);
 }
 
+// retune the receiver without a full RADIO_SetupRegisters(),
+// toggling REG_30 makes the PLL relock on the new frequency
+void BK4819_TuneTo(uint32_t Frequency)
+{
+    BK4819_SetFrequency(Frequency);
+    BK4819_PickRXFilterPathBasedOnFrequency(Frequency);
+
+    const uint16_t reg = BK4819_ReadRegister(BK4819_REG_30);
+    BK4819_WriteRegister(BK4819_REG_30, 0);
+    BK4819_WriteRegister(BK4819_REG_30, reg);
+}
+
 void BK4819_SetupSquelch(
         uint8_t SquelchOpenRSSIThresh,
         uint8_t SquelchCloseRSSIThresh,
@@ -21,6 +21,26 @@ void CRC_Init(void)
 {
 }
 
+uint16_t CRC_Update(uint16_t Crc, uint8_t Byte)
+{
+    Crc ^= (Byte << 8);
+
+    for (int j = 0; j < 8; j++)
+    {
+        // Check bit [15]
+        if (Crc >> 15)
+        {
+            Crc = (Crc << 1) ^ 0x1021;
+        }
+        else
+        {
+            Crc = Crc << 1;
+        }
+    }
+
+    return Crc;
+}
+
 uint16_t CRC_Calculate(const void *pBuffer, uint16_t Size)
 {
     const uint8_t *pData = (const uint8_t *)pBuffer;
@@ -29,20 +49,7 @@ uint16_t CRC_Calculate(const void *pBuffer, uint16_t Size)
     Crc = 0;
     for (i = 0; i < Size; i++)
     {
-        Crc ^= (pData[i] << 8);
-
-        for (int j = 0; j < 8; j++)
-        {
-            // Check bit [15]
-            if (Crc >> 15)
-            {
-                Crc = (Crc << 1) ^ 0x1021;
-            }
-            else
-            {
-                Crc = Crc << 1;
-            }
-        }
+        Crc = CRC_Update(Crc, pData[i]);
     }
 
     return Crc;
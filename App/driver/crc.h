@@ -20,6 +20,7 @@
 #include <stdint.h>
 
 void CRC_Init(void);
+uint16_t CRC_Update(uint16_t Crc, uint8_t Byte);
 uint16_t CRC_Calculate(const void *pBuffer, uint16_t Size);
 
 #endif
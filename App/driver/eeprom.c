@@ -61,3 +61,10 @@ void EEPROM_WriteBuffer(uint16_t Address, const void *pBuffer)
     // give the EEPROM time to burn the data in (apparently takes 5ms)
     SYSTEM_DelayMs(8);
 }
+
+// the I2C EEPROM pages are 8 bytes, Size must be a multiple of it
+void EEPROM_WriteBlock(uint16_t Address, const void *pBuffer, uint16_t Size)
+{
+    for (uint16_t i = 0; i < Size; i += 8)
+        EEPROM_WriteBuffer(Address + i, (const uint8_t *)pBuffer + i);
+}
@@ -21,6 +21,7 @@
 
 void EEPROM_ReadBuffer(uint16_t Address, void *pBuffer, uint8_t Size);
 void EEPROM_WriteBuffer(uint16_t Address, const void *pBuffer);
+void EEPROM_WriteBlock(uint16_t Address, const void *pBuffer, uint16_t Size);
 
 #endif
 
@@ -90,8 +90,13 @@ void EEPROM_ReadBuffer(uint16_t Address, void *pBuffer, uint8_t Size)
 void EEPROM_WriteBuffer(uint16_t Address, const void *pBuffer)
 {
     // Write 8 bytes!!
+    EEPROM_WriteBlock(Address, pBuffer, 8);
+}
 
-    uint16_t Size = 8;
+// Each flash sector the range touches is read, erased and programmed once,
+// where writing it 8 bytes at a time costs a cycle per 8 bytes changed
+void EEPROM_WriteBlock(uint16_t Address, const void *pBuffer, uint16_t Size)
+{
     while (Size)
     {
         uint32_t PY_Addr;
@@ -16,6 +16,9 @@
  *     limitations under the License.
  */
 
+#ifdef ENABLE_FEAT_F4HWN_WFI
+    #include "py32f071_ll_exti.h"
+#endif
 #include "driver/gpio.h"
 #include "driver/keyboard.h"
 #include "driver/systick.h"
@@ -125,3 +128,63 @@ KEY_Code_t KEYBOARD_Poll(void)
 
     return Key;
 }
+
+#ifdef ENABLE_FEAT_F4HWN_WFI
+// rows and PTT (PB10) are inputs with pull ups, see BOARD_GPIO_Init()
+#define PIN_MASK_PTT        LL_GPIO_PIN_10
+#define EXTI_LINES_KEYS     (LL_EXTI_LINE_15 | LL_EXTI_LINE_14 | LL_EXTI_LINE_13 | LL_EXTI_LINE_12 | LL_EXTI_LINE_10)
+
+void KEYBOARD_InitWake(void)
+{
+    LL_EXTI_SetEXTISource(LL_EXTI_CONFIG_PORTB, LL_EXTI_CONFIG_LINE10);
+    LL_EXTI_SetEXTISource(LL_EXTI_CONFIG_PORTB, LL_EXTI_CONFIG_LINE12);
+    LL_EXTI_SetEXTISource(LL_EXTI_CONFIG_PORTB, LL_EXTI_CONFIG_LINE13);
+    LL_EXTI_SetEXTISource(LL_EXTI_CONFIG_PORTB, LL_EXTI_CONFIG_LINE14);
+    LL_EXTI_SetEXTISource(LL_EXTI_CONFIG_PORTB, LL_EXTI_CONFIG_LINE15);
+    LL_EXTI_EnableFallingTrig(EXTI_LINES_KEYS);
+
+    NVIC_SetPriority(EXTI4_15_IRQn, 1);
+    NVIC_EnableIRQ(EXTI4_15_IRQn);
+}
+
+// Drives every column low so that any key or the PTT gives a falling edge
+// on its row, and lets that edge wake the core up. A key already down holds
+// its row low and would never give that edge: then nothing is armed, the
+// columns go back high and false is returned.
+bool KEYBOARD_ArmWake(void)
+{
+    LL_GPIO_ResetOutputPin(GPIOx, PIN_MASK_COLS);
+    __NOP(); __NOP(); __NOP(); __NOP();
+
+    if ((LL_GPIO_ReadInputPort(GPIOx) & (PIN_MASK_ROWS | PIN_MASK_PTT)) != (PIN_MASK_ROWS | PIN_MASK_PTT)) {
+        LL_GPIO_SetOutputPin(GPIOx, PIN_MASK_COLS);
+        return false;
+    }
+
+    LL_EXTI_ClearFlag(EXTI_LINES_KEYS);
+    LL_EXTI_EnableIT(EXTI_LINES_KEYS);
+
+    return true;
+}
+
+// To be called with interrupts still disabled after the sleep, returns true
+// when a key or the PTT ended it
+bool KEYBOARD_DisarmWake(void)
+{
+    const bool keyWake = LL_EXTI_ReadFlag(EXTI_LINES_KEYS) != 0;
+
+    LL_EXTI_DisableIT(EXTI_LINES_KEYS);
+    LL_EXTI_ClearFlag(EXTI_LINES_KEYS);
+    NVIC_ClearPendingIRQ(EXTI4_15_IRQn);
+
+    LL_GPIO_SetOutputPin(GPIOx, PIN_MASK_COLS);
+
+    return keyWake;
+}
+
+// only wakes the core up, KEYBOARD_DisarmWake() tells who did it
+void EXTI4_15_IRQHandler(void)
+{
+    LL_EXTI_ClearFlag(EXTI_LINES_KEYS);
+}
+#endif
@@ -52,5 +52,11 @@ extern bool       gWasFKeyPressed;
 
 KEY_Code_t KEYBOARD_Poll(void);
 
+#ifdef ENABLE_FEAT_F4HWN_WFI
+void       KEYBOARD_InitWake(void);
+bool       KEYBOARD_ArmWake(void);
+bool       KEYBOARD_DisarmWake(void);
+#endif
+
 #endif
 
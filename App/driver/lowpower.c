@@ -0,0 +1,126 @@
+/* Copyright 2025 Armel F4HWN
+ * https://github.com/armel
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *     Unless required by applicable law or agreed to in writing, software
+ *     distributed under the License is distributed on an "AS IS" BASIS,
+ *     WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *     See the License for the specific language governing permissions and
+ *     limitations under the License.
+ */
+
+#include "py32f0xx.h"
+#include "py32f071_ll_bus.h"
+#include "py32f071_ll_exti.h"
+#include "py32f071_ll_lptim.h"
+#include "py32f071_ll_pwr.h"
+#include "py32f071_ll_rcc.h"
+#include "driver/lowpower.h"
+
+// LPTIM1 runs from the 32.768kHz LSI divided by 32, 1024 counts per second,
+// so its 16 bit counter covers a bit more than a minute of STOP mode
+#define LPTIM_HZ        1024
+#define LPTIM_MAX       0xFFFF
+
+#define EXTI_LINE_LPTIM LL_EXTI_LINE_29
+
+static uint32_t remainder;      // LPTIM counts not yet turned into 10ms ticks
+
+void LOWPOWER_Init(void)
+{
+    LL_RCC_LSI_Enable();
+    while (!LL_RCC_LSI_IsReady()) {}
+
+    LL_RCC_SetLPTIMClockSource(LL_RCC_LPTIM1_CLKSOURCE_LSI);
+    LL_APB1_GRP1_EnableClock(LL_APB1_GRP1_PERIPH_LPTIM1);
+    LL_LPTIM_SetPrescaler(LPTIM1, LL_LPTIM_PRESCALER_DIV32);
+    LL_LPTIM_EnableIT_ARRM(LPTIM1);
+
+    // the key lines are set up by KEYBOARD_InitWake()
+    NVIC_SetPriority(TIM6_LPTIM1_DAC_IRQn, 1);
+    NVIC_EnableIRQ(TIM6_LPTIM1_DAC_IRQn);
+}
+
+static uint32_t ReadCounter(void)
+{
+    // the counter runs on its own clock, read until two reads agree
+    uint32_t a;
+    uint32_t b = LL_LPTIM_GetCounter(LPTIM1);
+
+    do {
+        a = b;
+        b = LL_LPTIM_GetCounter(LPTIM1);
+    } while (a != b);
+
+    return a;
+}
+
+// Stops the core for up to Ticks_10ms, SysTick included, and returns the
+// number of 10ms ticks actually spent, a key press can cut it short when
+// armed with KEYBOARD_ArmWake(). To be called with interrupts disabled,
+// they still wake the core up.
+uint32_t LOWPOWER_Stop(uint32_t Ticks_10ms)
+{
+    const uint32_t counts  = Ticks_10ms * LPTIM_HZ / 100;
+    const uint32_t sysclk  = LL_RCC_GetSysClkSource();
+    uint32_t       elapsed;
+
+    if (counts < 2)
+        return 0;
+
+    LL_LPTIM_Enable(LPTIM1);
+    LL_LPTIM_SetAutoReload(LPTIM1, counts > LPTIM_MAX ? LPTIM_MAX : counts);
+    LL_LPTIM_ClearFLAG_ARRM(LPTIM1);
+    LL_EXTI_ClearFlag(EXTI_LINE_LPTIM);
+    LL_EXTI_EnableIT(EXTI_LINE_LPTIM);
+
+    SysTick->CTRL &= ~SysTick_CTRL_ENABLE_Msk;
+
+    LL_LPTIM_StartCounter(LPTIM1, LL_LPTIM_OPERATING_MODE_ONESHOT);
+
+    LL_PWR_EnableLowPowerRunMode();     // low power regulator during STOP
+    SCB->SCR |= SCB_SCR_SLEEPDEEP_Msk;
+    __WFI();
+    SCB->SCR &= ~SCB_SCR_SLEEPDEEP_Msk;
+    LL_PWR_DisableLowPowerRunMode();
+
+    // the core comes back on the HSI, bring the PLL back if it was in use
+    if (sysclk == LL_RCC_SYS_CLKSOURCE_STATUS_PLL) {
+        LL_RCC_PLL_Enable();
+        while (!LL_RCC_PLL_IsReady()) {}
+        LL_RCC_SetSysClkSource(LL_RCC_SYS_CLKSOURCE_PLL);
+        while (LL_RCC_GetSysClkSource() != LL_RCC_SYS_CLKSOURCE_STATUS_PLL) {}
+    }
+
+    // any other enabled interrupt may also have ended the sleep early
+    if (LL_LPTIM_IsActiveFlag_ARRM(LPTIM1))
+        elapsed = LL_LPTIM_GetAutoReload(LPTIM1);
+    else
+        elapsed = ReadCounter();
+
+    LL_LPTIM_Disable(LPTIM1);
+    LL_LPTIM_ClearFLAG_ARRM(LPTIM1);
+    LL_EXTI_DisableIT(EXTI_LINE_LPTIM);
+    LL_EXTI_ClearFlag(EXTI_LINE_LPTIM);
+    NVIC_ClearPendingIRQ(TIM6_LPTIM1_DAC_IRQn);
+
+    SysTick->VAL   = 0;
+    SysTick->CTRL |= SysTick_CTRL_ENABLE_Msk;
+
+    // keep the fraction of a tick for the next time, no drift in the long run
+    elapsed   = elapsed * 100 + remainder;
+    remainder = elapsed % LPTIM_HZ;
+
+    return elapsed / LPTIM_HZ;
+}
+
+// only wakes the core up, LOWPOWER_Stop() reads the counter
+void TIM6_LPTIM1_DAC_IRQHandler(void)
+{
+    LL_EXTI_ClearFlag(EXTI_LINE_LPTIM);
+}
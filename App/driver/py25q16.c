@@ -26,6 +26,8 @@
 #include "driver/systick.h"
 #include "external/printf/printf.h"
 
+#include "profiler.h"
+
 // #define DEBUG
 
 #define SPIx SPI2
@@ -42,6 +44,25 @@ static uint8_t SectorCache[SECTOR_SIZE];
 static uint8_t BlackHole[1];
 static volatile bool TC_Flag;
 
+#ifdef ENABLE_FEAT_F4HWN_FLASH_CACHE
+// Read-through cache for the small reads (settings, channels, names...),
+// so that reading a byte here and there does not cost a command, an
+// address and a byte by byte transfer each time. Lines are never dirty:
+// programming updates them and erasing drops them.
+#define CHIP_SIZE    0x200000
+#define LINE_SIZE    PAGE_SIZE
+#define CACHE_LINES  4
+#define LINE_INVALID 0xFFFFFFFF
+
+static uint8_t  CacheData[CACHE_LINES][LINE_SIZE];   // adjacent lines are contiguous
+static uint32_t CacheAddr[CACHE_LINES] = {LINE_INVALID, LINE_INVALID, LINE_INVALID, LINE_INVALID};
+static uint32_t CacheAge[CACHE_LINES];
+static uint32_t CacheClock;
+static uint32_t LastFill = LINE_INVALID;
+
+PY25Q16_CacheStats_t gFlashCacheStats;
+#endif
+
 static inline void CS_Assert()
 {
     GPIO_ResetOutputPin(CS_PIN);
@@ -224,11 +245,8 @@ void PY25Q16_Init()
     SPI_Init();
 }
 
-void PY25Q16_ReadBuffer(uint32_t Address, void *pBuffer, uint32_t Size)
+static void FlashRead(uint32_t Address, void *pBuffer, uint32_t Size)
 {
-#ifdef DEBUG
-    printf("spi flash read: %06x %ld\n", Address, Size);
-#endif
     CS_Assert();
 
     SPI_WriteByte(0x03); // Fast read
@@ -249,6 +267,151 @@ void PY25Q16_ReadBuffer(uint32_t Address, void *pBuffer, uint32_t Size)
     CS_Release();
 }
 
+#ifdef ENABLE_FEAT_F4HWN_FLASH_CACHE
+static int CacheFind(uint32_t LineAddr)
+{
+    for (int i = 0; i < CACHE_LINES; i++)
+    {
+        if (CacheAddr[i] == LineAddr)
+        {
+            return i;
+        }
+    }
+
+    return -1;
+}
+
+static uint32_t PairAge(int Slot)
+{
+    return CacheAge[Slot] > CacheAge[Slot + 1] ? CacheAge[Slot] : CacheAge[Slot + 1];
+}
+
+static int CacheFill(uint32_t LineAddr)
+{
+    int Slot = 0;
+
+    // walking forward (channel lists, scan log...): take the next line in
+    // the same transfer, into the adjacent slot
+    if (LineAddr == LastFill + LINE_SIZE && LineAddr + 2 * LINE_SIZE <= CHIP_SIZE && CacheFind(LineAddr + LINE_SIZE) < 0)
+    {
+        for (int i = 1; i + 1 < CACHE_LINES; i++)
+        {
+            if (PairAge(i) < PairAge(Slot))
+            {
+                Slot = i;
+            }
+        }
+
+        FlashRead(LineAddr, CacheData[Slot], 2 * LINE_SIZE);
+
+        CacheAddr[Slot + 1] = LineAddr + LINE_SIZE;
+        CacheAge[Slot + 1]  = CacheClock;
+        LastFill            = LineAddr + LINE_SIZE;
+        gFlashCacheStats.Prefetches++;
+    }
+    else
+    {
+        for (int i = 1; i < CACHE_LINES; i++)
+        {
+            if (CacheAge[i] < CacheAge[Slot])
+            {
+                Slot = i;
+            }
+        }
+
+        FlashRead(LineAddr, CacheData[Slot], LINE_SIZE);
+
+        LastFill = LineAddr;
+    }
+
+    CacheAddr[Slot] = LineAddr;
+
+    return Slot;
+}
+
+static void CacheRead(uint32_t Address, uint8_t *pBuffer, uint32_t Size)
+{
+    bool Hit = true;
+
+    while (Size)
+    {
+        const uint32_t LineAddr = Address - (Address % LINE_SIZE);
+        const uint32_t Offset = Address - LineAddr;
+        const uint32_t Chunk = (Size < LINE_SIZE - Offset) ? Size : LINE_SIZE - Offset;
+
+        int Slot = CacheFind(LineAddr);
+        if (Slot < 0)
+        {
+            Slot = CacheFill(LineAddr);
+            Hit = false;
+        }
+
+        CacheAge[Slot] = ++CacheClock;
+        memcpy(pBuffer, CacheData[Slot] + Offset, Chunk);
+
+        Address += Chunk;
+        pBuffer += Chunk;
+        Size -= Chunk;
+    }
+
+    if (Hit)
+    {
+        gFlashCacheStats.Hits++;
+    }
+    else
+    {
+        gFlashCacheStats.Misses++;
+    }
+}
+
+static void CacheErase(uint32_t SecAddr)
+{
+    for (int i = 0; i < CACHE_LINES; i++)
+    {
+        if (CacheAddr[i] - SecAddr < SECTOR_SIZE)
+        {
+            CacheAddr[i] = LINE_INVALID;
+            CacheAge[i] = 0;
+        }
+    }
+}
+
+// the target bytes were erased, so the flash now holds exactly Buf
+static void CacheProgram(uint32_t Addr, const uint8_t *Buf, uint32_t Size)
+{
+    const int Slot = CacheFind(Addr - (Addr % LINE_SIZE));
+    if (Slot >= 0)
+    {
+        memcpy(CacheData[Slot] + (Addr % LINE_SIZE), Buf, Size);
+    }
+}
+
+void PY25Q16_ResetCacheStats(void)
+{
+    memset(&gFlashCacheStats, 0, sizeof(gFlashCacheStats));
+}
+#endif
+
+void PY25Q16_ReadBuffer(uint32_t Address, void *pBuffer, uint32_t Size)
+{
+#ifdef DEBUG
+    printf("spi flash read: %06x %ld\n", Address, Size);
+#endif
+#ifdef ENABLE_FEAT_F4HWN_FLASH_CACHE
+    // whole pages and more (sector cache, voice clips, scan log) go
+    // straight to the DMA, they would only evict the small stuff
+    if (Size < LINE_SIZE)
+    {
+        CacheRead(Address, pBuffer, Size);
+        return;
+    }
+
+    gFlashCacheStats.Bypasses++;
+#endif
+
+    FlashRead(Address, pBuffer, Size);
+}
+
 void PY25Q16_WriteBuffer(uint32_t Address, const void *pBuffer, uint32_t Size, bool Append)
 {
 #ifdef DEBUG
@@ -325,6 +488,25 @@ void PY25Q16_SectorErase(uint32_t Address)
     }
 }
 
+// Program without the read-modify-erase cycle of PY25Q16_WriteBuffer(),
+// the caller guarantees the target bytes are erased (0xFF)
+void PY25Q16_PageProgram(uint32_t Address, const void *pBuffer, uint32_t Size)
+{
+    SectorProgram(Address, pBuffer, Size);
+
+    // keep the sector cache coherent
+    uint32_t SecAddr = Address - (Address % SECTOR_SIZE);
+    if (SecAddr == SectorCacheAddr)
+    {
+        uint32_t SecOffset = Address % SECTOR_SIZE;
+        if (Size > SECTOR_SIZE - SecOffset)
+        {
+            Size = SECTOR_SIZE - SecOffset;
+        }
+        memcpy(SectorCache + SecOffset, pBuffer, Size);
+    }
+}
+
 static inline void WriteAddr(uint32_t Addr)
 {
     SPI_WriteByte(0xff & (Addr >> 16));
@@ -383,6 +565,9 @@ static void SectorErase(uint32_t Addr)
 {
 #ifdef DEBUG
     printf("spi flash sector erase: %06x\n", Addr);
+#endif
+#if defined(ENABLE_FEAT_F4HWN_PROFILER) || defined(ENABLE_FEAT_F4HWN_DEADLINE)
+    const PROFILER_Frame_t frame = PROFILER_Enter(PROFILER_FLASH_WRITE);
 #endif
     WriteEnable();
     WaitWIP();
@@ -393,6 +578,14 @@ static void SectorErase(uint32_t Addr)
     CS_Release();
 
     WaitWIP();
+
+#ifdef ENABLE_FEAT_F4HWN_FLASH_CACHE
+    CacheErase(Addr);
+#endif
+
+#if defined(ENABLE_FEAT_F4HWN_PROFILER) || defined(ENABLE_FEAT_F4HWN_DEADLINE)
+    PROFILER_Leave(PROFILER_FLASH_WRITE, frame);
+#endif
 }
 
 static void SectorProgram(uint32_t Addr, const uint8_t *Buf, uint32_t Size)
@@ -421,6 +614,9 @@ static void PageProgram(uint32_t Addr, const uint8_t *Buf, uint32_t Size)
 #ifdef DEBUG
     printf("spi flash page program: %06x %ld\n", Addr, Size);
 #endif
+#if defined(ENABLE_FEAT_F4HWN_PROFILER) || defined(ENABLE_FEAT_F4HWN_DEADLINE)
+    const PROFILER_Frame_t frame = PROFILER_Enter(PROFILER_FLASH_WRITE);
+#endif
 
     WriteEnable();
     // WaitWIP();
@@ -445,6 +641,14 @@ static void PageProgram(uint32_t Addr, const uint8_t *Buf, uint32_t Size)
     CS_Release();
 
     WaitWIP();
+
+#ifdef ENABLE_FEAT_F4HWN_FLASH_CACHE
+    CacheProgram(Addr, Buf, Size);
+#endif
+
+#if defined(ENABLE_FEAT_F4HWN_PROFILER) || defined(ENABLE_FEAT_F4HWN_DEADLINE)
+    PROFILER_Leave(PROFILER_FLASH_WRITE, frame);
+#endif
 }
 
 void DMA1_Channel4_5_6_7_IRQHandler()
@@ -20,9 +20,32 @@
 #include <stdint.h>
 #include <stdbool.h>
 
+// Flash map. The EEPROM image takes the sectors below PY25Q16_CALIB_ADDR,
+// see eeprom_compat.c, the voice prompts run from PY25Q16_VOICE_ADDR to the
+// end. What lies in between is free for the firmware to use.
+#define PY25Q16_SECTOR_SIZE     0x1000
+#define PY25Q16_CALIB_ADDR      0x010000    // calibration, one sector
+#define PY25Q16_SCANLOG_ADDR    0x020000    // scan log ring
+#define PY25Q16_SCANLOG_SECTORS 2
+#define PY25Q16_VOICE_ADDR      0x14c000    // voice prompt tables, then clips
+
 void PY25Q16_Init();
 void PY25Q16_ReadBuffer(uint32_t Address, void *pBuffer, uint32_t Size);
 void PY25Q16_WriteBuffer(uint32_t Address, const void *pBuffer, uint32_t Size, bool Append);
 void PY25Q16_SectorErase(uint32_t Address);
+void PY25Q16_PageProgram(uint32_t Address, const void *pBuffer, uint32_t Size);
+
+#ifdef ENABLE_FEAT_F4HWN_FLASH_CACHE
+typedef struct {
+    uint32_t Hits;          // small reads served from RAM
+    uint32_t Misses;        // small reads that had to fill a line
+    uint32_t Prefetches;    // fills that took the next line too
+    uint32_t Bypasses;      // page sized reads, not cached
+} PY25Q16_CacheStats_t;
+
+extern PY25Q16_CacheStats_t gFlashCacheStats;
+
+void PY25Q16_ResetCacheStats(void);
+#endif
 
 #endif
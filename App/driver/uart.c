@@ -26,10 +26,21 @@
 
 #define USARTx USART1
 #define DMA_CHANNEL LL_DMA_CHANNEL_2
+#define DMA_CHANNEL_TX LL_DMA_CHANNEL_1
+
+// Bytes to send are queued in TxRing and drained by DMA, one contiguous
+// run at a time, so that callers only wait when the ring is full.
+#define TX_RING_SIZE 1024   // power of 2
+#define TX_RING_MASK (TX_RING_SIZE - 1)
 
 static bool UART_IsLogEnabled;
 uint8_t UART_DMA_Buffer[256];
 
+static uint8_t TxRing[TX_RING_SIZE];
+static volatile uint16_t TxHead;    // free running, written by UART_Send()
+static volatile uint16_t TxTail;    // free running, moved by the DMA interrupt
+static volatile uint16_t TxChunk;   // bytes in flight, 0 when the DMA is idle
+
 void UART_Init(void)
 {
     // PA9 TX
@@ -78,6 +89,30 @@ void UART_Init(void)
 
         LL_SYSCFG_SetDMARemap(DMA1, DMA_CHANNEL, LL_SYSCFG_DMA_MAP_USART1_RD);
 
+        LL_DMA_DisableChannel(DMA1, DMA_CHANNEL_TX);
+
+        LL_DMA_StructInit(&DMA_InitStruct);
+
+        DMA_InitStruct.Direction = LL_DMA_DIRECTION_MEMORY_TO_PERIPH;
+        DMA_InitStruct.Mode = LL_DMA_MODE_NORMAL;
+        DMA_InitStruct.PeriphOrM2MSrcAddress = LL_USART_DMA_GetRegAddr(USARTx);
+        DMA_InitStruct.PeriphOrM2MSrcIncMode = LL_DMA_PERIPH_NOINCREMENT;
+        DMA_InitStruct.PeriphOrM2MSrcDataSize = LL_DMA_PDATAALIGN_BYTE;
+        DMA_InitStruct.MemoryOrM2MDstAddress = (uint32_t)TxRing;
+        DMA_InitStruct.MemoryOrM2MDstDataSize = LL_DMA_MDATAALIGN_BYTE;
+        DMA_InitStruct.MemoryOrM2MDstIncMode = LL_DMA_MEMORY_INCREMENT;
+        DMA_InitStruct.NbData = 0;
+        DMA_InitStruct.Priority = LL_DMA_PRIORITY_LOW;
+
+        LL_DMA_Init(DMA1, DMA_CHANNEL_TX, &DMA_InitStruct);
+
+        LL_SYSCFG_SetDMARemap(DMA1, DMA_CHANNEL_TX, LL_SYSCFG_DMA_MAP_USART1_WR);
+
+        LL_DMA_EnableIT_TC(DMA1, DMA_CHANNEL_TX);
+
+        NVIC_SetPriority(DMA1_Channel1_IRQn, 2);
+        NVIC_EnableIRQ(DMA1_Channel1_IRQn);
+
     } while (0);
 
     LL_APB1_GRP2_ForceReset(LL_APB1_GRP2_PERIPH_USART1);
@@ -96,6 +131,7 @@ void UART_Init(void)
         LL_USART_Init(USARTx, &USART_InitStruct);
 
         LL_USART_EnableDMAReq_RX(USARTx);
+        LL_USART_EnableDMAReq_TX(USARTx);
 
     } while (0);
 
@@ -104,34 +140,92 @@ void UART_Init(void)
     LL_USART_TransmitData8(USARTx, 0);
 }
 
+// interrupts are disabled, or this is the DMA interrupt
+static void StartTx(void)
+{
+    const uint16_t pending = TxHead - TxTail;
+
+    if (TxChunk != 0 || pending == 0)
+        return;
+
+    const uint16_t offset = TxTail & TX_RING_MASK;
+
+    // up to the end of the ring, the rest goes with the next run
+    TxChunk = (pending < TX_RING_SIZE - offset) ? pending : TX_RING_SIZE - offset;
+
+    LL_DMA_DisableChannel(DMA1, DMA_CHANNEL_TX);
+    LL_DMA_SetMemoryAddress(DMA1, DMA_CHANNEL_TX, (uint32_t)&TxRing[offset]);
+    LL_DMA_SetDataLength(DMA1, DMA_CHANNEL_TX, TxChunk);
+    LL_DMA_EnableChannel(DMA1, DMA_CHANNEL_TX);
+}
+
+uint32_t UART_GetTxFree(void)
+{
+    return TX_RING_SIZE - (uint16_t)(TxHead - TxTail);
+}
+
+bool UART_IsSending(void)
+{
+    return TxChunk != 0 || !LL_USART_IsActiveFlag_TC(USARTx);
+}
+
 void UART_Send(const void *pBuffer, uint32_t Size)
 {
     const uint8_t *pData = (const uint8_t *)pBuffer;
-    uint32_t i;
 
-    for (i = 0; i < Size; i++)
+    while (Size)
     {
-        while (!LL_USART_IsActiveFlag_TXE(USARTx))
+        uint32_t Free;
+
+        // back pressure: only wait for room, never for the line
+        while ((Free = UART_GetTxFree()) == 0)
             ;
-        LL_USART_TransmitData8(USARTx, pData[i]);
+
+        const uint16_t offset = TxHead & TX_RING_MASK;
+        uint32_t       chunk  = (Size < Free) ? Size : Free;
+
+        if (chunk > TX_RING_SIZE - offset)
+            chunk = TX_RING_SIZE - offset;
+
+        memcpy(&TxRing[offset], pData, chunk);
+
+        __disable_irq();
+        TxHead += chunk;
+        StartTx();
+        __enable_irq();
+
+        pData += chunk;
+        Size  -= chunk;
     }
 }
 
+// queue the whole buffer or nothing
+bool UART_TrySend(const void *pBuffer, uint32_t Size)
+{
+    if (Size > UART_GetTxFree())
+        return false;
+
+    UART_Send(pBuffer, Size);
+
+    return true;
+}
+
 void UART_LogSend(const void *pBuffer, uint32_t Size)
 {
     if (UART_IsLogEnabled) {
-        UART_Send(pBuffer, Size);
+        // logs are dropped rather than hold up the caller
+        UART_TrySend(pBuffer, Size);
     }
 }
 
-#ifdef ENABLE_FEAT_F4HWN_SCREENSHOT
-    bool UART_IsCableConnected(void) {
-        for (size_t i = 0; i < sizeof(UART_DMA_Buffer); i++) {
-            if (UART_DMA_Buffer[i] == 0x55) {
-                UART_DMA_Buffer[i] = 0x00;  // Clear only the matched byte
-                return true;
-            }
-        }
-        return false;
+void DMA1_Channel1_IRQHandler(void)
+{
+    if (LL_DMA_IsActiveFlag_TC1(DMA1))
+    {
+        LL_DMA_ClearFlag_TC1(DMA1);
+
+        TxTail += TxChunk;
+        TxChunk = 0;
+        StartTx();
     }
-#endif
+}
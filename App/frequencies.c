@@ -18,6 +18,7 @@
 #include "misc.h"
 #include "settings.h"
 #include <assert.h>
+#include <stdbool.h>
 
 // the BK4819 has 2 bands it covers, 18MHz ~ 630MHz and 760MHz ~ 1300MHz
 
@@ -27,24 +28,54 @@
 const freq_band_table_t BX4819_band1 = {BX4819_band1_lower,  63000000};
 const freq_band_table_t BX4819_band2 = {84000000, BX4819_band2_upper};
 
+// band edges, the band table, the band lookup and the TX plans below are
+// all built from these
+#ifndef ENABLE_WIDE_RX
+    // QS original
+    #define BAND1_LOWER  5000000
+    #define BAND1_UPPER  7600000
+    #define BAND7_UPPER 60000000
+#else
+    // extended range
+    #define BAND1_LOWER BX4819_band1_lower
+    #define BAND1_UPPER 10800000
+    #define BAND7_UPPER BX4819_band2_upper
+#endif
+#define BAND2_LOWER 10800000
+#define BAND3_LOWER 13700000
+#define BAND4_LOWER 17400000
+#define BAND5_LOWER 35000000
+#define BAND6_LOWER 40000000
+#define BAND7_LOWER 47000000
+
 const freq_band_table_t frequencyBandTable[] =
 {
-    #ifndef ENABLE_WIDE_RX
-        // QS original
-        [BAND1_50MHz ]={.lower =  5000000,  .upper =  7600000},
-        [BAND7_470MHz]={.lower = 47000000,  .upper = 60000000},
-    #else
-        // extended range
-        [BAND1_50MHz ]={.lower =  BX4819_band1_lower, .upper =  10800000},
-        [BAND7_470MHz]={.lower = 47000000, .upper = BX4819_band2_upper},
-    #endif
-        [BAND2_108MHz]={.lower = 10800000,  .upper = 13700000},
-        [BAND3_137MHz]={.lower = 13700000,  .upper = 17400000},
-        [BAND4_174MHz]={.lower = 17400000,  .upper = 35000000},
-        [BAND5_350MHz]={.lower = 35000000,  .upper = 40000000},
-        [BAND6_400MHz]={.lower = 40000000,  .upper = 47000000}
+    [BAND1_50MHz ]={.lower = BAND1_LOWER,  .upper = BAND1_UPPER},
+    [BAND2_108MHz]={.lower = BAND2_LOWER,  .upper = BAND3_LOWER},
+    [BAND3_137MHz]={.lower = BAND3_LOWER,  .upper = BAND4_LOWER},
+    [BAND4_174MHz]={.lower = BAND4_LOWER,  .upper = BAND5_LOWER},
+    [BAND5_350MHz]={.lower = BAND5_LOWER,  .upper = BAND6_LOWER},
+    [BAND6_400MHz]={.lower = BAND6_LOWER,  .upper = BAND7_LOWER},
+    [BAND7_470MHz]={.lower = BAND7_LOWER,  .upper = BAND7_UPPER}
 };
 
+// last frequency below each band, padded to a power of two so that
+// FREQUENCY_GetBand() bisects it without branches; the UINT32_MAX pad is
+// never exceeded, so even an erased 0xFFFFFFFF frequency stays in band 7
+static const uint32_t bandBelow[8] =
+{
+    0,  // unused, band 1 takes anything below band 2
+    BAND2_LOWER - 1,
+    BAND3_LOWER - 1,
+    BAND4_LOWER - 1,
+    BAND5_LOWER - 1,
+    BAND6_LOWER - 1,
+    BAND7_LOWER - 1,
+    UINT32_MAX
+};
+
+static_assert(BAND_N_ELEM == 7);
+
 #ifdef ENABLE_NOAA
     const uint32_t NoaaFrequencyTable[10] =
     {
@@ -117,11 +148,13 @@ static_assert(ARRAY_SIZE(gStepFrequencyTable) == STEP_N_ELEM);
 
 FREQUENCY_Band_t FREQUENCY_GetBand(uint32_t Frequency)
 {
-    for (int32_t band = BAND_N_ELEM - 1; band >= 0; band--)
-        if (Frequency >= frequencyBandTable[band].lower)
-            return (FREQUENCY_Band_t)band;
+    uint32_t band = 0;
+
+    band += (Frequency > bandBelow[band + 4]) << 2;
+    band += (Frequency > bandBelow[band + 2]) << 1;
+    band += (Frequency > bandBelow[band + 1]);
 
-    return BAND1_50MHz;
+    return (FREQUENCY_Band_t)band;
 }
 
 uint8_t FREQUENCY_CalculateOutputPower(uint8_t TxpLow, uint8_t TxpMid, uint8_t TxpHigh, int32_t LowerLimit, int32_t Middle, int32_t UpperLimit, int32_t Frequency)
@@ -159,116 +192,157 @@ uint32_t FREQUENCY_RoundToStep(uint32_t freq, uint16_t step)
     return (freq + (step + 1) / 2) / step * step;
 }
 
-int32_t TX_freq_check(const uint32_t Frequency)
-{   // return '0' if TX frequency is allowed
-    // otherwise return '-1'
+// TX band plans, one list of [lower, upper) ranges per F_LOCK mode, some
+// ranges also depending on a setting. Single frequencies and inclusive
+// upper edges are written as X + 1.
+typedef enum {
+    TX_GATE_NONE,
+    TX_GATE_200,
+    TX_GATE_350,
+    TX_GATE_500
+} TX_Gate_t;
+
+typedef struct {
+    uint32_t lower;
+    uint32_t upper;
+    uint8_t  gate;
+} tx_range_t;
+
+typedef struct {
+    const tx_range_t *range;
+    uint8_t           count;
+} tx_plan_t;
+
+static const tx_range_t txDEF[] = {
+    {BAND3_LOWER, BAND4_LOWER,  TX_GATE_NONE},
+    {BAND4_LOWER, BAND5_LOWER,  TX_GATE_200},
+    {BAND5_LOWER, BAND6_LOWER,  TX_GATE_350},
+    {BAND6_LOWER, BAND7_LOWER,  TX_GATE_NONE},
+    {BAND7_LOWER, 60000000 + 1, TX_GATE_500},
+};
 
-    if (Frequency < frequencyBandTable[0].lower || Frequency > frequencyBandTable[BAND_N_ELEM - 1].upper)
-        return -1;  // not allowed outside this range
+static const tx_range_t txFCC[] = {
+    {14400000, 14800000},
+    {42000000, 45000000},
+};
 
-    if (Frequency >= BX4819_band1.upper && Frequency < BX4819_band2.lower)
-        return -1;  // BX chip does not work in this range
+#ifdef ENABLE_FEAT_F4HWN_CA
+static const tx_range_t txCA[] = {
+    {14400000, 14800000},
+    {43000000, 45000000},
+};
+#endif
 
-    switch (gSetting_F_LOCK)
-    {
-        case F_LOCK_DEF:
-            if (Frequency >= frequencyBandTable[BAND3_137MHz].lower && Frequency < frequencyBandTable[BAND3_137MHz].upper)
-                return 0;
-            if (Frequency >= frequencyBandTable[BAND4_174MHz].lower && Frequency < frequencyBandTable[BAND4_174MHz].upper)
-            #ifndef ENABLE_FEAT_F4HWN
-                if (gSetting_200TX)
-            #endif
-                    return 0;
-            if (Frequency >= frequencyBandTable[BAND5_350MHz].lower && Frequency < frequencyBandTable[BAND5_350MHz].upper)
-            #ifndef ENABLE_FEAT_F4HWN
-                if (gSetting_350TX && gSetting_350EN)
-            #else
-                if (gSetting_350EN)                
-            #endif
-                    return 0;
-            if (Frequency >= frequencyBandTable[BAND6_400MHz].lower && Frequency < frequencyBandTable[BAND6_400MHz].upper)
-                return 0;
-            if (Frequency >= frequencyBandTable[BAND7_470MHz].lower && Frequency <= 60000000)
-            #ifndef ENABLE_FEAT_F4HWN
-                if (gSetting_500TX)
-            #endif
-                    return 0;
-            break;
-
-        case F_LOCK_FCC:
-            if (Frequency >= 14400000 && Frequency < 14800000)
-                return 0;
-            if (Frequency >= 42000000 && Frequency < 45000000)
-                return 0;
-            break;
-
-        case F_LOCK_CE:
-            if (Frequency >= 14400000 && Frequency < 14600000)
-                return 0;
-            if (Frequency >= 43000000 && Frequency < 44000000)
-                return 0;
-            break;
-
-        case F_LOCK_GB:
-            if (Frequency >= 14400000 && Frequency < 14800000)
-                return 0;
-            if (Frequency >= 43000000 && Frequency < 44000000)
-                return 0;
-            break;
-
-        case F_LOCK_430:
-            if (Frequency >= frequencyBandTable[BAND3_137MHz].lower && Frequency < 17400000)
-                return 0;
-            if (Frequency >= 40000000 && Frequency < 43000000)
-                return 0;
-            break;
-
-        case F_LOCK_438:
-            if (Frequency >= frequencyBandTable[BAND3_137MHz].lower && Frequency < 17400000)
-                return 0;
-            if (Frequency >= 40000000 && Frequency < 43800000)
-                return 0;
-            break;
+static const tx_range_t txCE[] = {
+    {14400000, 14600000},
+    {43000000, 44000000},
+};
+
+static const tx_range_t txGB[] = {
+    {14400000, 14800000},
+    {43000000, 44000000},
+};
+
+static const tx_range_t tx430[] = {
+    {BAND3_LOWER, 17400000},
+    {40000000,    43000000},
+};
+
+static const tx_range_t tx438[] = {
+    {BAND3_LOWER, 17400000},
+    {40000000,    43800000},
+};
 
 #ifdef ENABLE_FEAT_F4HWN_PMR
-        case F_LOCK_PMR:
-            if (Frequency >= 44600625 && Frequency <= 44619375)
-                return 0;
-            break;
+static const tx_range_t txPMR[] = {
+    {44600625, 44619375 + 1},
+};
 #endif
 
 #ifdef ENABLE_FEAT_F4HWN_GMRS_FRS_MURS
-        case F_LOCK_GMRS_FRS_MURS:
-            // https://forums.radioreference.com/threads/the-great-unofficial-radioreference-frs-gmrs-murs-fact-sheet.275370/
-            if ((Frequency >= 46255000 && Frequency <= 46272500) ||
-                (Frequency >= 46755000 && Frequency <= 46772500)) // FRS/GMRS
-                return 0;
-            if (Frequency == 15182000 || 
-                Frequency == 15188000 || 
-                Frequency == 15194000 || 
-                Frequency == 15457000 || 
-                Frequency == 15460000) // MURS
-                return 0;
-            break;
+// https://forums.radioreference.com/threads/the-great-unofficial-radioreference-frs-gmrs-murs-fact-sheet.275370/
+static const tx_range_t txGMRS_FRS_MURS[] = {
+    {46255000, 46272500 + 1},   // FRS/GMRS
+    {46755000, 46772500 + 1},
+    {15182000, 15182000 + 1},   // MURS
+    {15188000, 15188000 + 1},
+    {15194000, 15194000 + 1},
+    {15457000, 15457000 + 1},
+    {15460000, 15460000 + 1},
+};
+#endif
+
+static const tx_range_t txNONE[] = {
+    {BAND1_LOWER, BAND1_UPPER},
+    {BAND2_LOWER, BAND3_LOWER},
+    {BAND3_LOWER, BAND4_LOWER},
+    {BAND4_LOWER, BAND5_LOWER},
+    {BAND5_LOWER, BAND6_LOWER},
+    {BAND6_LOWER, BAND7_LOWER},
+    {BAND7_LOWER, BAND7_UPPER},
+};
+
+#define TX_PLAN(x) {x, ARRAY_SIZE(x)}
+
+// F_LOCK_ALL has no range at all
+static const tx_plan_t txPlans[F_LOCK_LEN] = {
+    [F_LOCK_DEF]           = TX_PLAN(txDEF),
+    [F_LOCK_FCC]           = TX_PLAN(txFCC),
+#ifdef ENABLE_FEAT_F4HWN_CA
+    [F_LOCK_CA]            = TX_PLAN(txCA),
+#endif
+    [F_LOCK_CE]            = TX_PLAN(txCE),
+    [F_LOCK_GB]            = TX_PLAN(txGB),
+    [F_LOCK_430]           = TX_PLAN(tx430),
+    [F_LOCK_438]           = TX_PLAN(tx438),
+#ifdef ENABLE_FEAT_F4HWN_PMR
+    [F_LOCK_PMR]           = TX_PLAN(txPMR),
+#endif
+#ifdef ENABLE_FEAT_F4HWN_GMRS_FRS_MURS
+    [F_LOCK_GMRS_FRS_MURS] = TX_PLAN(txGMRS_FRS_MURS),
 #endif
+    [F_LOCK_NONE]          = TX_PLAN(txNONE),
+};
 
-#ifdef ENABLE_FEAT_F4HWN_CA 
-        case F_LOCK_CA:
-            if (Frequency >= 14400000 && Frequency < 14800000)
-                return 0;
-            if (Frequency >= 43000000 && Frequency < 45000000)
-                return 0;
-            break;
+static bool TX_GateOpen(const uint8_t gate)
+{
+    switch (gate)
+    {
+#ifndef ENABLE_FEAT_F4HWN
+        case TX_GATE_200:
+            return gSetting_200TX;
+        case TX_GATE_350:
+            return gSetting_350TX && gSetting_350EN;
+        case TX_GATE_500:
+            return gSetting_500TX;
+#else
+        case TX_GATE_350:
+            return gSetting_350EN;
 #endif
+        default:
+            return true;
+    }
+}
+
+int32_t TX_freq_check(const uint32_t Frequency)
+{   // return '0' if TX frequency is allowed
+    // otherwise return '-1'
+
+    if (Frequency < frequencyBandTable[0].lower || Frequency > frequencyBandTable[BAND_N_ELEM - 1].upper)
+        return -1;  // not allowed outside this range
+
+    if (Frequency >= BX4819_band1.upper && Frequency < BX4819_band2.lower)
+        return -1;  // BX chip does not work in this range
+
+    if (gSetting_F_LOCK >= F_LOCK_LEN)
+        return -1;
 
-        case F_LOCK_ALL:
-            break;
+    const tx_plan_t *pPlan = &txPlans[gSetting_F_LOCK];
 
-        case F_LOCK_NONE:
-            for (uint32_t i = 0; i < ARRAY_SIZE(frequencyBandTable); i++)
-                if (Frequency >= frequencyBandTable[i].lower && Frequency < frequencyBandTable[i].upper)
-                    return 0;
-            break;
+    for (uint8_t i = 0; i < pPlan->count; i++) {
+        const tx_range_t *pRange = &pPlan->range[i];
+        if (Frequency >= pRange->lower && Frequency < pRange->upper && TX_GateOpen(pRange->gate))
+            return 0;
     }
 
     // dis-allowed TX frequency
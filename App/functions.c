@@ -33,8 +33,12 @@
 #include "frequencies.h"
 #include "functions.h"
 #include "helper/battery.h"
+#ifdef ENABLE_FEAT_F4HWN_ADAPTIVE_SAVE
+    #include "helper/dutycycle.h"
+#endif
 #include "misc.h"
 #include "radio.h"
+#include "scheduler.h"
 #include "settings.h"
 #include "ui/status.h"
 #include "ui/ui.h"
@@ -57,11 +61,11 @@ void FUNCTION_Init(void)
     g_SquelchLost      = false;
 
     gFlagTailNoteEliminationComplete   = false;
-    gTailNoteEliminationCountdown_10ms = 0;
+    SCHEDULER_StopTimer(&gTailNoteEliminationTimer);
     gFoundCTCSS                        = false;
     gFoundCDCSS                        = false;
-    gFoundCTCSSCountdown_10ms          = 0;
-    gFoundCDCSSCountdown_10ms          = 0;
+    SCHEDULER_StopTimer(&gFoundCTCSSTimer);
+    SCHEDULER_StopTimer(&gFoundCDCSSTimer);
     gEndOfRxDetectedMaybe              = false;
 
     gCurrentCodeType = (gRxVfo->Modulation != MODULATION_FM) ? CODE_TYPE_OFF : gRxVfo->pRX->CodeType;
@@ -75,7 +79,7 @@ void FUNCTION_Init(void)
 #endif
 
 #ifdef ENABLE_NOAA
-    gNOAACountdown_10ms = 0;
+    SCHEDULER_StopTimer(&gNOAACountdownTimer);
 
     if (IS_NOAA_CHANNEL(gRxVfo->CHANNEL_SAVE)) {
         gCurrentCodeType = CODE_TYPE_OFF;
@@ -120,14 +124,20 @@ void FUNCTION_PowerSave() {
     #ifdef ENABLE_FEAT_F4HWN_SLEEP
         if(gWakeUp)
         {
-            gPowerSave_10ms = gEeprom.BATTERY_SAVE * 200; // deep sleep now indexed on BatSav
+            SCHEDULER_StartTimer(&gPowerSaveTimer, gEeprom.BATTERY_SAVE * 200); // deep sleep now indexed on BatSav
         }
         else
         {
-            gPowerSave_10ms = gEeprom.BATTERY_SAVE * 10;
+            #ifdef ENABLE_FEAT_F4HWN_ADAPTIVE_SAVE
+                SCHEDULER_StartTimer(&gPowerSaveTimer, DUTYCYCLE_NextOff_10ms());
+            #else
+                SCHEDULER_StartTimer(&gPowerSaveTimer, gEeprom.BATTERY_SAVE * 10);
+            #endif
         }
+    #elif defined(ENABLE_FEAT_F4HWN_ADAPTIVE_SAVE)
+        SCHEDULER_StartTimer(&gPowerSaveTimer, DUTYCYCLE_NextOff_10ms());
     #else
-        gPowerSave_10ms = gEeprom.BATTERY_SAVE * 10;
+        SCHEDULER_StartTimer(&gPowerSaveTimer, gEeprom.BATTERY_SAVE * 10);
     #endif
     gPowerSaveCountdownExpired = false;
 
@@ -266,10 +276,18 @@ void FUNCTION_Select(FUNCTION_Type_t Function)
     const FUNCTION_Type_t PreviousFunction = gCurrentFunction;
     const bool bWasPowerSave = PreviousFunction == FUNCTION_POWER_SAVE;
 
+    // RX, TX and power save all take the BK4819 and the audio path over
+    if (Function != FUNCTION_FOREGROUND)
+        AUDIO_CompleteBeep();
+
     gCurrentFunction = Function;
+    SCHEDULER_HoldCountdowns();
 
     if (bWasPowerSave && Function != FUNCTION_POWER_SAVE) {
         BK4819_Conditional_RX_TurnOn_and_GPIO6_Enable();
+#ifdef ENABLE_FEAT_F4HWN_STOP
+        SCHEDULER_MarkRxOn();
+#endif
         gRxIdleMode = false;
         UI_DisplayStatus();
     }
@@ -316,8 +334,8 @@ void FUNCTION_Select(FUNCTION_Type_t Function)
         gMonitor = true;
     }
 
-    gBatterySaveCountdown_10ms = battery_save_count_10ms;
-    gSchedulePowerSave         = false;
+    SCHEDULER_StartTimer(&gBatterySaveTimer, battery_save_count_10ms);
+    gSchedulePowerSave = false;
 
 #if defined(ENABLE_FMRADIO)
     if(Function != FUNCTION_INCOMING)
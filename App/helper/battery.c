@@ -48,7 +48,12 @@ typedef enum {
 uint16_t          lowBatteryCountdown;
 const uint16_t    lowBatteryPeriod = 30;
 
-volatile uint16_t gPowerSave_10ms;
+static void PowerSaveExpired(void)
+{
+    gPowerSaveCountdownExpired = true;
+}
+
+SCHEDULER_Timer_t gPowerSaveTimer = {.pCallback = PowerSaveExpired};
 
 const uint16_t Voltage2PercentageTable[][7][2] = {
     [BATTERY_TYPE_1600_MAH] = {
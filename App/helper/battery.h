@@ -20,6 +20,8 @@
 #include <stdbool.h>
 #include <stdint.h>
 
+#include "scheduler_timer.h"
+
 extern uint16_t          gBatteryCalibration[6];
 extern uint16_t          gBatteryCurrentVoltage;
 extern uint16_t          gBatteryCurrent;
@@ -32,7 +34,7 @@ extern bool              gLowBattery;
 extern bool              gLowBatteryConfirmed;
 extern uint16_t          gBatteryCheckCounter;
 
-extern volatile uint16_t gPowerSave_10ms;
+extern SCHEDULER_Timer_t gPowerSaveTimer;
 
 typedef enum {
     BATTERY_TYPE_1600_MAH,
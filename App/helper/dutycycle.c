@@ -0,0 +1,121 @@
+/* Copyright 2025 Armel F4HWN
+ * https://github.com/armel
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *     Unless required by applicable law or agreed to in writing, software
+ *     distributed under the License is distributed on an "AS IS" BASIS,
+ *     WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *     See the License for the specific language governing permissions and
+ *     limitations under the License.
+ */
+
+#include <stdbool.h>
+#include <string.h>
+
+#include "helper/dutycycle.h"
+#include "misc.h"
+#include "scheduler.h"
+#include "settings.h"
+
+// The BK4819 sleeps for an off period, then listens for power_save1_10ms.
+// BATTERY_SAVE gives the nominal off period. Squelch activity brings it
+// down to half of that, and every silent window stretches it by a quarter,
+// up to DUTYCYCLE_MAX_OFF_10ms, which bounds the wake latency. On a busy
+// net, this hour, the previous one or the same hour the day before, the
+// off period never grows past the nominal one.
+#define DUTYCYCLE_MIN_OFF_10ms  5
+#define DUTYCYCLE_MAX_OFF_10ms  100     // 1 sec
+#define DUTYCYCLE_BUSY_HOUR     4       // squelch openings
+#define TICKS_PER_HOUR          (60 * 60 * 100)
+
+DUTYCYCLE_Hour_t gDutyCycleHours[DUTYCYCLE_HOURS];
+
+static uint32_t hourNumber;
+static bool     yesterdayBusy;
+static bool     activity;
+static uint16_t offPeriod;
+
+static bool IsBusy(const DUTYCYCLE_Hour_t *pHour)
+{
+    return pHour->Activity >= DUTYCYCLE_BUSY_HOUR;
+}
+
+static DUTYCYCLE_Hour_t *CurrentHour(void)
+{
+    const uint32_t now  = SCHEDULER_GetTicks_10ms() / TICKS_PER_HOUR;
+    uint32_t       diff = now - hourNumber;
+
+    // a day or more without a call, or the tick counter wrapped (now went
+    // backwards): nothing in the ring is still relevant, start over
+    if (diff >= DUTYCYCLE_HOURS) {
+        memset(gDutyCycleHours, 0, sizeof(gDutyCycleHours));
+        yesterdayBusy = false;
+        hourNumber    = now;
+        diff          = 0;
+    }
+
+    // the slot we move into still holds the same hour of the day before
+    for (; diff > 0; diff--) {
+        hourNumber++;
+
+        DUTYCYCLE_Hour_t *pHour = &gDutyCycleHours[hourNumber % DUTYCYCLE_HOURS];
+        yesterdayBusy = IsBusy(pHour);
+        memset(pHour, 0, sizeof(*pHour));
+    }
+
+    return &gDutyCycleHours[hourNumber % DUTYCYCLE_HOURS];
+}
+
+uint16_t DUTYCYCLE_NextOff_10ms(void)
+{
+    const uint16_t          nominal  = gEeprom.BATTERY_SAVE * 10;
+    DUTYCYCLE_Hour_t       *pHour    = CurrentHour();
+    const DUTYCYCLE_Hour_t *pPrev    = &gDutyCycleHours[(hourNumber + DUTYCYCLE_HOURS - 1) % DUTYCYCLE_HOURS];
+    const bool              busy     = IsBusy(pHour) || (hourNumber > 0 && IsBusy(pPrev)) || yesterdayBusy;
+    const uint16_t          lower    = MAX(nominal / 2, DUTYCYCLE_MIN_OFF_10ms);
+    const uint16_t          upper    = busy ? nominal : MAX(nominal, DUTYCYCLE_MAX_OFF_10ms);
+
+    if (nominal == 0)
+        return 0;
+
+    if (offPeriod == 0)
+        offPeriod = nominal;
+
+    if (activity) {
+        activity  = false;
+        offPeriod = lower;
+    }
+    else {
+        offPeriod = MIN(offPeriod + offPeriod / 4 + 1, upper);
+    }
+
+    // BATTERY_SAVE may have been lowered from the menu in the meantime
+    offPeriod = MAX(MIN(offPeriod, upper), lower);
+
+    pHour->Windows++;
+    pHour->OffTicks += offPeriod;
+
+    return offPeriod;
+}
+
+void DUTYCYCLE_MarkActivity(void)
+{
+    DUTYCYCLE_Hour_t *pHour = CurrentHour();
+
+    if (pHour->Activity < UINT16_MAX)
+        pHour->Activity++;
+
+    activity = true;
+}
+
+uint8_t DUTYCYCLE_GetCurrentHour(void)
+{
+    CurrentHour();
+
+    return hourNumber % DUTYCYCLE_HOURS;
+}
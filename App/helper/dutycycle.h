@@ -0,0 +1,37 @@
+/* Copyright 2025 Armel F4HWN
+ * https://github.com/armel
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *     Unless required by applicable law or agreed to in writing, software
+ *     distributed under the License is distributed on an "AS IS" BASIS,
+ *     WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *     See the License for the specific language governing permissions and
+ *     limitations under the License.
+ */
+
+#ifndef DUTYCYCLE_H
+#define DUTYCYCLE_H
+
+#include <stdint.h>
+
+#define DUTYCYCLE_HOURS 24
+
+// one slot per hour of uptime, the ring covers the last day
+typedef struct {
+    uint16_t Activity;      // squelch openings
+    uint16_t Windows;       // power save sleep and listen cycles
+    uint32_t OffTicks;      // 10ms ticks spent with the BK4819 asleep
+} __attribute__((packed)) DUTYCYCLE_Hour_t;
+
+extern DUTYCYCLE_Hour_t gDutyCycleHours[DUTYCYCLE_HOURS];
+
+uint16_t DUTYCYCLE_NextOff_10ms(void);
+void     DUTYCYCLE_MarkActivity(void);
+uint8_t  DUTYCYCLE_GetCurrentHour(void);
+
+#endif
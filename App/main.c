@@ -25,7 +25,9 @@
 #include "audio.h"
 #include "board.h"
 #include "misc.h"
+#include "profiler.h"
 #include "radio.h"
+#include "scheduler.h"
 #include "settings.h"
 #include "version.h"
 
@@ -49,6 +51,9 @@
 #include "driver/system.h"
 #include "driver/systick.h"
 #include "driver/py25q16.h"
+#ifdef ENABLE_FEAT_F4HWN_STOP
+    #include "driver/lowpower.h"
+#endif
 #ifdef ENABLE_UART
     #include "driver/uart.h"
 #endif
@@ -73,12 +78,33 @@ void _putchar(__attribute__((unused)) char c)
 
 }
 
+#ifdef ENABLE_PWRON_PASSWORD
+static void WaitWelcome(void)
+{
+    while (SCHEDULER_IsTimerRunning(&gBootTimer))
+    {
+        if (KEYBOARD_Poll() != KEY_INVALID)
+        {   // halt boot beeps
+            SCHEDULER_StopTimer(&gBootTimer);
+            break;
+        }
+    }
+}
+#endif
+
 void Main(void)
 {
     SYSTICK_Init();
     BOARD_Init();
+#ifdef ENABLE_FEAT_F4HWN_WFI
+    KEYBOARD_InitWake();
+#endif
+#ifdef ENABLE_FEAT_F4HWN_STOP
+    LOWPOWER_Init();
+#endif
 
-    boot_counter_10ms = 250;   // 2.5 sec
+    SCHEDULER_StartTimer(&gBootTimer, 250);   // 2.5 sec
+    SCHEDULER_StartTimer(&gBatterySaveTimer, battery_save_count_10ms);
 
 #ifdef ENABLE_UART
     UART_Init();
@@ -114,6 +140,8 @@ void Main(void)
 
     RADIO_SetupRegisters(true);
 
+    gBootRxOn_us = SCHEDULER_GetMicros();
+
     for (unsigned int i = 0; i < ARRAY_SIZE(gBatteryVoltages); i++)
         BOARD_ADC_GetBatteryInfo(&gBatteryVoltages[i], &gBatteryCurrent);
 
@@ -223,21 +251,20 @@ void Main(void)
 #else
         if (gEeprom.POWER_ON_DISPLAY_MODE != POWER_ON_DISPLAY_MODE_NONE)
 #endif
-        {   // 2.55 second boot-up screen
-            while (boot_counter_10ms > 0)
-            {
-                if (KEYBOARD_Poll() != KEY_INVALID)
-                {   // halt boot beeps
-                    boot_counter_10ms = 0;
-                    break;
-                }
-            }
-            RADIO_SetupRegisters(true);
+        {   // 2.55 second boot-up screen, APP_Update() keeps it up while
+            // the radio already listens behind it
+            gWelcomeHold = true;
         }
 
 #ifdef ENABLE_PWRON_PASSWORD
         if (gEeprom.POWER_ON_PASSWORD < 1000000)
         {
+            if (gWelcomeHold)
+            {   // the lock screen comes after the boot-up screen
+                WaitWelcome();
+                gWelcomeHold = false;
+            }
+
             bIsInLockScreen = true;
             UI_DisplayLock();
             bIsInLockScreen = false;
@@ -356,17 +383,31 @@ void Main(void)
         }
         #endif
     #endif
-        
+
+    gBootReady_us = SCHEDULER_GetMicros();
+
     while (true) {
-        APP_Update();
+        PROFILE(PROFILER_APP_UPDATE, APP_Update());
+        SCHEDULER_HoldCountdowns();
 
         if (gNextTimeslice) {
 
-            APP_TimeSlice10ms();
+            PROFILE(PROFILER_TIMESLICE_10MS, APP_TimeSlice10ms());
 
             if (gNextTimeslice_500ms) {
-                APP_TimeSlice500ms();
+                PROFILE(PROFILER_TIMESLICE_500MS, APP_TimeSlice500ms());
             }
         }
+#ifdef ENABLE_FEAT_F4HWN_WFI
+        else if (SCHEDULER_TakeEvent(SCHEDULER_EVENT_KEY)) {
+            APP_KeyWake();
+        }
+        else {
+            // only sleep after a pass without timeslice, so that what the
+            // timeslice raised (squelch, DTMF, keys...) goes through
+            // APP_Update() right away rather than on the next tick
+            SCHEDULER_Idle();
+        }
+#endif
     }
 }
@@ -166,17 +166,27 @@ uint16_t          gEEPROM_1F8C;
 ChannelAttributes_t gMR_ChannelAttributes[FREQ_CHANNEL_LAST + 1];
 bool                gMR_ChannelExclude[FREQ_CHANNEL_LAST + 1];
 
-volatile uint16_t gBatterySaveCountdown_10ms = battery_save_count_10ms;
-
 volatile bool     gPowerSaveCountdownExpired;
 volatile bool     gSchedulePowerSave;
 
+static void BatterySaveExpired(void)
+{
+    gSchedulePowerSave = true;
+}
+
+SCHEDULER_Timer_t gBatterySaveTimer = {.pCallback = BatterySaveExpired};
+
 volatile bool     gScheduleDualWatch = true;
 
-volatile uint16_t gDualWatchCountdown_10ms;
+static void DualWatchExpired(void)
+{
+    gScheduleDualWatch = true;
+}
+
+SCHEDULER_Timer_t gDualWatchTimer = {.pCallback = DualWatchExpired};
 bool              gDualWatchActive           = false;
 
-volatile uint8_t  gSerialConfigCountDown_500ms;
+SCHEDULER_Timer_t gSerialConfigTimer;
 
 volatile bool     gNextTimeslice_500ms;
 
@@ -195,12 +205,22 @@ volatile bool     gTxTimeoutReached;
     #endif
 #endif
 
-volatile uint16_t gTailNoteEliminationCountdown_10ms;
+static void TailNoteEliminationComplete(void)
+{
+    gFlagTailNoteEliminationComplete = true;
+}
+
+SCHEDULER_Timer_t gTailNoteEliminationTimer = {.pCallback = TailNoteEliminationComplete};
 
 volatile uint8_t    gVFOStateResumeCountdown_500ms;
 
 #ifdef ENABLE_NOAA
-    volatile uint16_t gNOAA_Countdown_10ms;
+    static void NOAAScanExpired(void)
+    {
+        gScheduleNOAA = true;
+    }
+
+    SCHEDULER_Timer_t gNOAAScanTimer = {.pCallback = NOAAScanExpired};
 #endif
 
 bool              gEnableSpeaker;
@@ -221,7 +241,13 @@ uint8_t           gBatteryVoltageIndex;
 bool              gCssBackgroundScan;
 
 volatile bool     gScheduleScanListen = true;
-volatile uint16_t gScanPauseDelayIn_10ms;
+
+static void ScanPauseExpired(void)
+{
+    gScheduleScanListen = true;
+}
+
+SCHEDULER_Timer_t gScanPauseTimer = {.pCallback = ScanPauseExpired};
 
 #if defined(ENABLE_ALARM) || defined(ENABLE_TX1750)
     AlarmState_t  gAlarmState;
@@ -290,14 +316,14 @@ bool              gF_LOCK = false;
 uint8_t           gShowChPrefix;
 
 volatile bool     gNextTimeslice;
-volatile uint8_t  gFoundCDCSSCountdown_10ms;
-volatile uint8_t  gFoundCTCSSCountdown_10ms;
+SCHEDULER_Timer_t gFoundCDCSSTimer;
+SCHEDULER_Timer_t gFoundCTCSSTimer;
 #ifdef ENABLE_VOX
-    volatile uint16_t gVoxStopCountdown_10ms;
+    SCHEDULER_Timer_t gVoxStopTimer;
 #endif
 volatile bool     gNextTimeslice40ms;
 #ifdef ENABLE_NOAA
-    volatile uint16_t gNOAACountdown_10ms = 0;
+    SCHEDULER_Timer_t gNOAACountdownTimer;
     volatile bool     gScheduleNOAA       = true;
 #endif
 volatile bool     gFlagTailNoteEliminationComplete;
@@ -305,7 +331,10 @@ volatile bool     gFlagTailNoteEliminationComplete;
     volatile bool gScheduleFM;
 #endif
 
-volatile uint8_t  boot_counter_10ms;
+SCHEDULER_Timer_t gBootTimer;
+bool              gWelcomeHold;
+uint32_t          gBootRxOn_us;     // BK4819 set up on the current VFO
+uint32_t          gBootReady_us;    // main loop serving the radio
 
 uint8_t           gIsLocked = 0xFF;
 
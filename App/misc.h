@@ -20,6 +20,8 @@
 #include <stdbool.h>
 #include <stdint.h>
 
+#include "scheduler_timer.h"
+
 #ifndef ARRAY_SIZE
     #define ARRAY_SIZE(x) (sizeof(x) / sizeof(x[0]))
 #endif
@@ -232,17 +234,17 @@ typedef union {
 extern ChannelAttributes_t   gMR_ChannelAttributes[207];
 extern bool                  gMR_ChannelExclude[207];
 
-extern volatile uint16_t     gBatterySaveCountdown_10ms;
+extern SCHEDULER_Timer_t    gBatterySaveTimer;
 
 extern volatile bool         gPowerSaveCountdownExpired;
 extern volatile bool         gSchedulePowerSave;
 
 extern volatile bool         gScheduleDualWatch;
 
-extern volatile uint16_t     gDualWatchCountdown_10ms;
+extern SCHEDULER_Timer_t    gDualWatchTimer;
 extern bool                  gDualWatchActive;
 
-extern volatile uint8_t      gSerialConfigCountDown_500ms;
+extern SCHEDULER_Timer_t    gSerialConfigTimer;
 
 extern volatile bool         gNextTimeslice_500ms;
 
@@ -261,10 +263,10 @@ extern volatile bool         gTxTimeoutReached;
     #endif
 #endif
 
-extern volatile uint16_t     gTailNoteEliminationCountdown_10ms;
+extern SCHEDULER_Timer_t    gTailNoteEliminationTimer;
 
 #ifdef ENABLE_NOAA
-    extern volatile uint16_t gNOAA_Countdown_10ms;
+    extern SCHEDULER_Timer_t gNOAAScanTimer;
 #endif
 extern bool                  gEnableSpeaker;
 extern uint8_t               gKeyInputCountdown;
@@ -295,7 +297,7 @@ enum
 };
 
 extern volatile bool     gScheduleScanListen;
-extern volatile uint16_t gScanPauseDelayIn_10ms;
+extern SCHEDULER_Timer_t gScanPauseTimer;
 
 extern AlarmState_t          gAlarmState;
 extern uint16_t              gMenuCountdown;
@@ -361,14 +363,14 @@ extern bool                  gF_LOCK;
     extern uint8_t           gFM_ChannelPosition;
 #endif
 extern uint8_t               gShowChPrefix;
-extern volatile uint8_t      gFoundCDCSSCountdown_10ms;
-extern volatile uint8_t      gFoundCTCSSCountdown_10ms;
+extern SCHEDULER_Timer_t    gFoundCDCSSTimer;
+extern SCHEDULER_Timer_t    gFoundCTCSSTimer;
 #ifdef ENABLE_VOX
-    extern volatile uint16_t gVoxStopCountdown_10ms;
+    extern SCHEDULER_Timer_t gVoxStopTimer;
 #endif
 extern volatile bool         gNextTimeslice40ms;
 #ifdef ENABLE_NOAA
-    extern volatile uint16_t gNOAACountdown_10ms;
+    extern SCHEDULER_Timer_t gNOAACountdownTimer;
     extern volatile bool     gScheduleNOAA;
 #endif
 extern volatile bool         gFlagTailNoteEliminationComplete;
@@ -377,7 +379,10 @@ extern volatile uint8_t      gVFOStateResumeCountdown_500ms;
     extern volatile bool     gScheduleFM;
 #endif
 extern uint8_t               gIsLocked;
-extern volatile uint8_t      boot_counter_10ms;
+extern SCHEDULER_Timer_t    gBootTimer;
+extern bool                  gWelcomeHold;
+extern uint32_t              gBootRxOn_us;
+extern uint32_t              gBootReady_us;
 
 #ifdef ENABLE_FEAT_F4HWN
     extern bool                  gK5startup;
@@ -394,6 +399,6 @@ unsigned long StrToUL(const char * str);
 
 void FUNCTION_NOP();
 
-static inline bool SerialConfigInProgress() { return gSerialConfigCountDown_500ms != 0; }
+static inline bool SerialConfigInProgress() { return SCHEDULER_IsTimerRunning(&gSerialConfigTimer); }
 
 #endif
@@ -0,0 +1,138 @@
+/* Copyright 2025 Armel F4HWN
+ * https://github.com/armel
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *     Unless required by applicable law or agreed to in writing, software
+ *     distributed under the License is distributed on an "AS IS" BASIS,
+ *     WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *     See the License for the specific language governing permissions and
+ *     limitations under the License.
+ */
+
+#include <string.h>
+
+#include "profiler.h"
+
+#ifdef ENABLE_FEAT_F4HWN_PROFILER
+PROFILER_Entry_t gProfiler[PROFILER_SECTION_COUNT];
+#endif
+
+#ifdef ENABLE_FEAT_F4HWN_DEADLINE
+uint32_t        gDeadlineMisses;
+PROFILER_Miss_t gDeadlineWorst[PROFILER_WORST_COUNT];
+
+static volatile uint8_t currentSection = PROFILER_NONE;
+static uint16_t         missSlices;
+static uint8_t          missSection;
+static uint32_t         missTick;
+#endif
+
+PROFILER_Frame_t PROFILER_Enter(PROFILER_Section_t Section)
+{
+    PROFILER_Frame_t frame = {0};
+
+#ifdef ENABLE_FEAT_F4HWN_DEADLINE
+    frame.Outer    = currentSection;
+    currentSection = Section;
+#else
+    (void)Section;
+#endif
+
+#ifdef ENABLE_FEAT_F4HWN_PROFILER
+    frame.Start = SCHEDULER_GetCycles();
+#endif
+
+    return frame;
+}
+
+void PROFILER_Leave(PROFILER_Section_t Section, PROFILER_Frame_t Frame)
+{
+#ifdef ENABLE_FEAT_F4HWN_PROFILER
+    // the cycle stamp wraps every ~89s, a plain difference is still right
+    const uint32_t    cycles = SCHEDULER_GetCycles() - Frame.Start;
+    PROFILER_Entry_t *pEntry = &gProfiler[Section];
+
+    pEntry->Cycles += cycles;
+    pEntry->Calls++;
+
+    if (cycles > pEntry->MaxCycles)
+        pEntry->MaxCycles = cycles;
+#else
+    (void)Section;
+#endif
+
+#ifdef ENABLE_FEAT_F4HWN_DEADLINE
+    currentSection = Frame.Outer;
+#endif
+}
+
+#ifdef ENABLE_FEAT_F4HWN_PROFILER
+void PROFILER_Reset(void)
+{
+    memset(gProfiler, 0, sizeof(gProfiler));
+}
+#endif
+
+#ifdef ENABLE_FEAT_F4HWN_DEADLINE
+static void RecordMiss(void)
+{
+    PROFILER_Miss_t *pSlot = &gDeadlineWorst[0];
+
+    // the table keeps the longest runs, the shortest one makes room
+    for (uint8_t i = 1; i < PROFILER_WORST_COUNT; i++) {
+        if (gDeadlineWorst[i].Slices < pSlot->Slices)
+            pSlot = &gDeadlineWorst[i];
+    }
+
+    if (missSlices <= pSlot->Slices)
+        return;
+
+    pSlot->Tick    = missTick;
+    pSlot->Slices  = missSlices;
+    pSlot->Section = missSection;
+    pSlot->Padding = 0;
+}
+
+// called from SysTick before it raises gNextTimeslice, Pending tells
+// that the previous slice has not been picked up by the main loop
+void PROFILER_CheckDeadline(bool Pending)
+{
+    if (Pending) {
+        if (missSlices == 0) {
+            missSection = currentSection;
+            missTick    = SCHEDULER_GetTicks_10ms();
+        }
+
+        if (missSlices < UINT16_MAX)
+            missSlices++;
+
+        gDeadlineMisses++;
+        return;
+    }
+
+    if (missSlices == 0)
+        return;
+
+    RecordMiss();
+    missSlices = 0;
+}
+
+// SysTick is a system exception, NVIC_DisableIRQ() cannot mask it: the
+// table is cleared with all interrupts off, along with the current miss run
+void PROFILER_ResetDeadline(void)
+{
+    const uint32_t primask = __get_PRIMASK();
+    __disable_irq();
+
+    gDeadlineMisses = 0;
+    missSlices      = 0;
+    memset(gDeadlineWorst, 0, sizeof(gDeadlineWorst));
+
+    __set_PRIMASK(primask);
+}
+#endif
@@ -0,0 +1,95 @@
+/* Copyright 2025 Armel F4HWN
+ * https://github.com/armel
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *     Unless required by applicable law or agreed to in writing, software
+ *     distributed under the License is distributed on an "AS IS" BASIS,
+ *     WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *     See the License for the specific language governing permissions and
+ *     limitations under the License.
+ */
+
+#ifndef PROFILER_H
+#define PROFILER_H
+
+#include <stdint.h>
+
+#if defined(ENABLE_FEAT_F4HWN_PROFILER) || defined(ENABLE_FEAT_F4HWN_DEADLINE)
+
+#include <stdbool.h>
+
+#include "scheduler.h"
+
+typedef enum {
+    PROFILER_APP_UPDATE,
+    PROFILER_RADIO_IRQ,
+    PROFILER_DISPLAY,
+    PROFILER_AM_FIX,
+    PROFILER_UART,
+    PROFILER_FLASH_WRITE,
+    PROFILER_TIMESLICE_10MS,
+    PROFILER_TIMESLICE_500MS,
+    PROFILER_SCREENSHOT,
+    PROFILER_SECTION_COUNT,
+    PROFILER_NONE = PROFILER_SECTION_COUNT
+} PROFILER_Section_t;
+
+typedef struct {
+    uint32_t Start;
+    uint8_t  Outer;
+} PROFILER_Frame_t;
+
+PROFILER_Frame_t PROFILER_Enter(PROFILER_Section_t Section);
+void             PROFILER_Leave(PROFILER_Section_t Section, PROFILER_Frame_t Frame);
+
+#define PROFILE(section, ...)                                           \
+    do {                                                                \
+        const PROFILER_Frame_t _profFrame = PROFILER_Enter(section);    \
+        __VA_ARGS__;                                                    \
+        PROFILER_Leave(section, _profFrame);                            \
+    } while (0)
+
+#ifdef ENABLE_FEAT_F4HWN_PROFILER
+// times are in 48MHz CPU cycles and include the nested sections
+typedef struct {
+    uint64_t Cycles;
+    uint32_t MaxCycles;
+    uint32_t Calls;
+} __attribute__((packed)) PROFILER_Entry_t;
+
+extern PROFILER_Entry_t gProfiler[PROFILER_SECTION_COUNT];
+
+void PROFILER_Reset(void);
+#endif
+
+#ifdef ENABLE_FEAT_F4HWN_DEADLINE
+#define PROFILER_WORST_COUNT 8
+
+// a run of 10ms slices lost in a row, blamed on the innermost section
+// that was running when the first one was missed
+typedef struct {
+    uint32_t Tick;
+    uint16_t Slices;
+    uint8_t  Section;
+    uint8_t  Padding;
+} __attribute__((packed)) PROFILER_Miss_t;
+
+extern uint32_t        gDeadlineMisses;
+extern PROFILER_Miss_t gDeadlineWorst[PROFILER_WORST_COUNT];
+
+void PROFILER_CheckDeadline(bool Pending);
+void PROFILER_ResetDeadline(void);
+#endif
+
+#else
+
+#define PROFILE(section, ...) do { __VA_ARGS__; } while (0)
+
+#endif
+
+#endif
@@ -19,6 +19,9 @@
 
 #include "am_fix.h"
 #include "app/dtmf.h"
+#ifdef ENABLE_FEAT_F4HWN_NWATCH
+    #include "app/nwatch.h"
+#endif
 #ifdef ENABLE_FMRADIO
     #include "app/fm.h"
 #endif
@@ -33,6 +36,7 @@
 #include "helper/battery.h"
 #include "misc.h"
 #include "radio.h"
+#include "scheduler.h"
 #include "settings.h"
 #include "ui/menu.h"
 
@@ -927,8 +931,8 @@ void RADIO_SetupRegisters(bool switchToForeground)
             {
                 gIsNoaaMode          = true;
                 gNoaaChannel         = gRxVfo->CHANNEL_SAVE - NOAA_CHANNEL_FIRST;
-                gNOAA_Countdown_10ms = NOAA_countdown_2_10ms;
-                gScheduleNOAA        = false;
+                SCHEDULER_StartTimer(&gNOAAScanTimer, NOAA_countdown_2_10ms);
+                gScheduleNOAA = false;
             }
             else
                 gIsNoaaMode = false;
@@ -1132,8 +1136,11 @@ void RADIO_PrepareTX(void)
     if (gEeprom.DUAL_WATCH != DUAL_WATCH_OFF)
     {   // dual-RX is enabled
 
-        gDualWatchCountdown_10ms = dual_watch_count_after_tx_10ms;
-        gScheduleDualWatch       = false;
+        SCHEDULER_StartTimer(&gDualWatchTimer, dual_watch_count_after_tx_10ms);
+        gScheduleDualWatch = false;
+#ifdef ENABLE_FEAT_F4HWN_NWATCH
+        NWATCH_BeginPass();
+#endif
 
         if (!gRxVfoIsActive)
         {   // use the current RX vfo
@@ -24,10 +24,28 @@
 #include "functions.h"
 #include "helper/battery.h"
 #include "misc.h"
+#include "profiler.h"
 #include "settings.h"
 
 #include "driver/backlight.h"
 #include "driver/gpio.h"
+#ifdef ENABLE_FEAT_F4HWN_WFI
+    #include "driver/keyboard.h"
+#endif
+#ifdef ENABLE_FEAT_F4HWN_STOP
+    #include "driver/bk4819.h"
+    #include "driver/lowpower.h"
+    #ifdef ENABLE_UART
+        #include "driver/uart.h"
+    #endif
+    #ifdef ENABLE_USB
+        #include "usbd_core.h"
+    #endif
+#endif
+
+#if defined(ENABLE_FEAT_F4HWN_STOP) && !defined(ENABLE_FEAT_F4HWN_WFI)
+    #error "ENABLE_FEAT_F4HWN_STOP needs ENABLE_FEAT_F4HWN_WFI"
+#endif
 
 #define DECREMENT(cnt) \
     do {               \
@@ -44,11 +62,371 @@
 
 static volatile uint32_t gGlobalSysTickCounter;
 
-// we come here every 10ms
-void SysTick_Handler(void)
+uint32_t SCHEDULER_GetTicks_10ms(void)
+{
+    return gGlobalSysTickCounter;
+}
+
+// time since power on in us, wraps after ~71 minutes, main context only
+uint32_t SCHEDULER_GetMicros(void)
+{
+    uint32_t ticks;
+    uint32_t elapsed;
+
+    do {
+        ticks   = gGlobalSysTickCounter;
+        elapsed = SysTick->LOAD - SysTick->VAL;
+    } while (ticks != gGlobalSysTickCounter);
+
+    // SysTick counts down at 48MHz, see SYSTICK_Init()
+    return ticks * 10000 + elapsed / 48;
+}
+
+uint32_t SCHEDULER_GetCycles(void)
+{
+    uint32_t ticks;
+    uint32_t elapsed;
+
+    do {
+        ticks   = gGlobalSysTickCounter;
+        elapsed = SysTick->LOAD - SysTick->VAL;
+    } while (ticks != gGlobalSysTickCounter);
+
+    // the Cortex-M0+ has no cycle counter, rebuild one from SysTick
+    return ticks * (SysTick->LOAD + 1) + elapsed;
+}
+
+// Timer wheel: WHEEL_LEVELS levels of WHEEL_SLOTS slots, level n slots being
+// WHEEL_SLOTS^n ticks wide. A timer sits in the slot of its expiry on the
+// finest level that can hold it, and moves down a level each time the tick
+// counter enters that slot, so each tick only walks the timers that expire
+// or cascade. Timers further than the wheel span wait in its last slot and
+// get placed again on cascade.
+#define WHEEL_BITS   4
+#define WHEEL_SLOTS  (1U << WHEEL_BITS)
+#define WHEEL_MASK   (WHEEL_SLOTS - 1)
+#define WHEEL_LEVELS 3
+#define WHEEL_SPAN   (1U << (WHEEL_BITS * WHEEL_LEVELS))
+
+static SCHEDULER_Timer_t *wheel[WHEEL_LEVELS][WHEEL_SLOTS];
+
+static void TimerLink(SCHEDULER_Timer_t *pTimer)
+{
+    const uint32_t now   = gGlobalSysTickCounter;
+    uint32_t       delta = pTimer->Expiry - now;
+    uint32_t       expiry = pTimer->Expiry;
+    unsigned int   level = 0;
+
+    if (delta >= WHEEL_SPAN) {
+        delta  = WHEEL_SPAN - 1;
+        expiry = now + delta;
+    }
+
+    while (delta >= (1U << (WHEEL_BITS * (level + 1))))
+        level++;
+
+    SCHEDULER_Timer_t **ppSlot = &wheel[level][(expiry >> (WHEEL_BITS * level)) & WHEEL_MASK];
+
+    pTimer->pNext  = *ppSlot;
+    pTimer->ppPrev = ppSlot;
+    if (*ppSlot)
+        (*ppSlot)->ppPrev = &pTimer->pNext;
+    *ppSlot = pTimer;
+}
+
+static void TimerUnlink(SCHEDULER_Timer_t *pTimer)
+{
+    *pTimer->ppPrev = pTimer->pNext;
+    if (pTimer->pNext)
+        pTimer->pNext->ppPrev = pTimer->ppPrev;
+}
+
+// a zero delay stops the timer, like a countdown set to 0 used to, a held
+// timer only takes the new delay and starts counting once released
+void SCHEDULER_StartTimer(SCHEDULER_Timer_t *pTimer, uint32_t Ticks_10ms)
+{
+    const uint32_t primask = __get_PRIMASK();
+    __disable_irq();
+
+    if (pTimer->Running && !pTimer->Held)
+        TimerUnlink(pTimer);
+
+    pTimer->Running = Ticks_10ms > 0;
+
+    if (pTimer->Running) {
+        if (pTimer->Held) {
+            pTimer->Expiry = Ticks_10ms;
+        } else {
+            pTimer->Expiry = gGlobalSysTickCounter + Ticks_10ms;
+            TimerLink(pTimer);
+        }
+    }
+
+    __set_PRIMASK(primask);
+}
+
+void SCHEDULER_StopTimer(SCHEDULER_Timer_t *pTimer)
+{
+    SCHEDULER_StartTimer(pTimer, 0);
+}
+
+// a held timer keeps its time left, like a countdown that is not
+// decremented, and is out of the wheel until released
+void SCHEDULER_HoldTimer(SCHEDULER_Timer_t *pTimer, bool Hold)
+{
+    if (pTimer->Held == Hold)
+        return;
+
+    const uint32_t primask = __get_PRIMASK();
+    __disable_irq();
+
+    if (pTimer->Running) {
+        if (Hold) {
+            TimerUnlink(pTimer);
+            pTimer->Expiry -= gGlobalSysTickCounter;
+        } else {
+            pTimer->Expiry += gGlobalSysTickCounter;
+            TimerLink(pTimer);
+        }
+    }
+
+    pTimer->Held = Hold;
+
+    __set_PRIMASK(primask);
+}
+
+uint32_t SCHEDULER_GetTimerRemaining(const SCHEDULER_Timer_t *pTimer)
+{
+    const uint32_t primask = __get_PRIMASK();
+    __disable_irq();
+
+    const uint32_t remaining = !pTimer->Running ? 0 :
+                               pTimer->Held    ? pTimer->Expiry :
+                                                 pTimer->Expiry - gGlobalSysTickCounter;
+
+    __set_PRIMASK(primask);
+
+    return remaining;
+}
+
+// ticks until the first timer of the wheel expires, UINT32_MAX if none runs
+uint32_t SCHEDULER_GetNextDeadline(void)
+{
+    uint32_t next = UINT32_MAX;
+
+    const uint32_t primask = __get_PRIMASK();
+    __disable_irq();
+
+    for (unsigned int level = 0; level < WHEEL_LEVELS; level++)
+        for (unsigned int slot = 0; slot < WHEEL_SLOTS; slot++)
+            for (const SCHEDULER_Timer_t *pTimer = wheel[level][slot]; pTimer; pTimer = pTimer->pNext)
+                if (pTimer->Expiry - gGlobalSysTickCounter < next)
+                    next = pTimer->Expiry - gGlobalSysTickCounter;
+
+    __set_PRIMASK(primask);
+
+    return next;
+}
+
+static void TimerTick(void)
+{
+    const uint32_t      now = gGlobalSysTickCounter;
+    SCHEDULER_Timer_t **ppSlot;
+    SCHEDULER_Timer_t  *pTimer;
+
+    // coarse levels first, whatever they hand down may be due right now
+    for (unsigned int level = WHEEL_LEVELS - 1; level > 0; level--) {
+        if (now & ((1U << (WHEEL_BITS * level)) - 1))
+            continue;
+
+        ppSlot = &wheel[level][(now >> (WHEEL_BITS * level)) & WHEEL_MASK];
+
+        while ((pTimer = *ppSlot)) {
+            TimerUnlink(pTimer);
+            TimerLink(pTimer);
+        }
+    }
+
+    // a callback may start any timer again, the slot is re-read each time
+    ppSlot = &wheel[0][now & WHEEL_MASK];
+
+    while ((pTimer = *ppSlot)) {
+        TimerUnlink(pTimer);
+        pTimer->Running = false;
+        if (pTimer->pCallback)
+            pTimer->pCallback();
+    }
+}
+
+#ifdef ENABLE_FEAT_F4HWN_WFI
+static volatile uint32_t pendingEvents;
+static volatile bool     idle;
+static volatile uint32_t idleTicks;
+static volatile uint32_t busyTicks;
+
+void SCHEDULER_PostEvent(uint32_t Event)
+{
+    pendingEvents |= Event;
+}
+
+#ifdef ENABLE_FEAT_F4HWN_STOP
+// below this the LPTIM and clock restart overhead is not worth it
+#define STOP_MIN_TICKS 3
+
+SCHEDULER_StopStats_t gStopStats;
+
+static uint32_t wakeTick;
+static uint32_t wakeMicros;
+static bool     wakePending;
+
+static void Tick(void);
+
+// How long the core may stay in STOP mode: only while the BK4819 sleeps
+// between two power save RX windows and nothing else needs the 10ms tick.
+// The sleep ends on the next countdown that fires, and never goes past a
+// 500ms boundary so that the 500ms timeslice keeps its pace.
+static uint32_t StopBudget(void)
+{
+    if (gCurrentFunction != FUNCTION_POWER_SAVE || !gRxIdleMode || gScanStateDir != SCAN_OFF)
+        return 0;
+
+    if (BACKLIGHT_IsOn() || SerialConfigInProgress() || gKeyReading0 != KEY_INVALID)
+        return 0;
+
+#ifdef ENABLE_UART
+    // the TX DMA would freeze halfway through a reply
+    if (UART_IsSending())
+        return 0;
+#endif
+
+#ifdef ENABLE_USB
+    // the USB peripheral runs from the 48MHz clock
+    if (usb_device_is_configured())
+        return 0;
+#endif
+
+    // the power save countdown and the ones it may hand over to are all
+    // in the wheel
+    return MIN(50 - gGlobalSysTickCounter % 50, SCHEDULER_GetNextDeadline());
+}
+
+// interrupts are disabled, SysTick is stopped along with the core and the
+// ticks it missed are replayed on wake up, countdowns and timers included
+static bool DeepSleep(void)
+{
+    const uint32_t budget = StopBudget();
+
+    if (budget < STOP_MIN_TICKS || !KEYBOARD_ArmWake())
+        return false;
+
+    const uint32_t slept   = LOWPOWER_Stop(budget);
+    const bool     keyWake = KEYBOARD_DisarmWake();
+
+    for (uint32_t i = 0; i < slept; i++)
+        Tick();
+
+    idleTicks            += slept;
+    gStopStats.Stops++;
+    gStopStats.StopTicks += slept;
+    gStopStats.KeyWakes  += keyWake;
+
+    wakeTick    = gGlobalSysTickCounter;
+    wakeMicros  = SCHEDULER_GetMicros();
+    wakePending = true;
+
+    return true;
+}
+
+// called once the BK4819 is listening again, after the power save timer or
+// a key brought it back
+void SCHEDULER_MarkRxOn(void)
+{
+    if (!wakePending)
+        return;
+
+    wakePending = false;
+
+    // RX came back for another reason long after the last STOP
+    if (gGlobalSysTickCounter - wakeTick > 10)
+        return;
+
+    gStopStats.WakeToRxLast_us = SCHEDULER_GetMicros() - wakeMicros;
+    gStopStats.WakeToRxMax_us  = MAX(gStopStats.WakeToRxMax_us, gStopStats.WakeToRxLast_us);
+}
+#endif
+
+// Everything the main loop reacts to is either set by an interrupt (SysTick
+// flags, USB, DMA) or sampled from the 10ms timeslice (BK4819 interrupts,
+// UART DMA ring), so with nothing pending the core can sleep until the next
+// interrupt. Peripherals keep running in sleep mode. Keys are sampled from
+// the timeslice too, but a new press also wakes the core through its EXTI
+// line and posts SCHEDULER_EVENT_KEY, so that its scan starts right away.
+void SCHEDULER_Idle(void)
+{
+    // the TOT alert blinker counts main loop passes, keep it spinning
+    if (gCurrentFunction == FUNCTION_TRANSMIT)
+        return;
+
+    // the beep steps are a few ms long, much finer than the tick
+    if (AUDIO_IsBeepPlaying())
+        return;
+
+    __disable_irq();
+
+    if (gNextTimeslice || pendingEvents) {
+        pendingEvents = 0;
+        __enable_irq();
+        return;
+    }
+
+#ifdef ENABLE_FEAT_F4HWN_STOP
+    if (DeepSleep()) {
+        __enable_irq();
+        return;
+    }
+#endif
+
+    // WFI still wakes up on a masked interrupt, which is then served
+    // right after re-enabling, while idle is still set
+    const bool armed = gKeyReading0 == KEY_INVALID && KEYBOARD_ArmWake();
+
+    idle = true;
+    __WFI();
+
+    if (armed && KEYBOARD_DisarmWake())
+        pendingEvents |= SCHEDULER_EVENT_KEY;
+
+    __enable_irq();
+    idle = false;
+}
+
+bool SCHEDULER_TakeEvent(uint32_t Event)
+{
+    __disable_irq();
+    const bool pending = (pendingEvents & Event) != 0;
+    pendingEvents &= ~Event;
+    __enable_irq();
+
+    return pending;
+}
+
+uint32_t SCHEDULER_GetIdleTicks(void)
+{
+    return idleTicks;
+}
+
+uint32_t SCHEDULER_GetBusyTicks(void)
+{
+    return busyTicks;
+}
+#endif
+
+static void Tick(void)
 {
     gGlobalSysTickCounter++;
-    
+
+    TimerTick();
+
     gNextTimeslice = true;
 
     if ((gGlobalSysTickCounter % 50) == 0) {
@@ -62,56 +440,51 @@ void SysTick_Handler(void)
 #endif
         
         DECREMENT_AND_TRIGGER(gTxTimerCountdown_500ms, gTxTimeoutReached);
-        DECREMENT(gSerialConfigCountDown_500ms);
     }
 
     if ((gGlobalSysTickCounter & 3) == 0)
         gNextTimeslice40ms = true;
+}
 
-#ifdef ENABLE_NOAA
-    DECREMENT(gNOAACountdown_10ms);
-#endif
-
-    DECREMENT(gFoundCDCSSCountdown_10ms);
-
-    DECREMENT(gFoundCTCSSCountdown_10ms);
-
-    if (gCurrentFunction == FUNCTION_FOREGROUND)
-        DECREMENT_AND_TRIGGER(gBatterySaveCountdown_10ms, gSchedulePowerSave);
-
-    if (gCurrentFunction == FUNCTION_POWER_SAVE)
-        DECREMENT_AND_TRIGGER(gPowerSave_10ms, gPowerSaveCountdownExpired);
+// The countdowns below only run in some radio states. Rather than checking
+// those states on every tick from SysTick, their wheel timers are held while
+// the state does not allow them to run. Called from the main loop on each
+// pass, after anything that may have changed the state.
+void SCHEDULER_HoldCountdowns(void)
+{
+    const bool busy  = gCurrentFunction == FUNCTION_MONITOR || gCurrentFunction == FUNCTION_TRANSMIT;
+    const bool rx    = gCurrentFunction == FUNCTION_RECEIVE;
+    const bool quiet = gScanStateDir == SCAN_OFF && !gCssBackgroundScan && !busy && !rx;
 
-    if (gScanStateDir == SCAN_OFF && !gCssBackgroundScan && gEeprom.DUAL_WATCH != DUAL_WATCH_OFF)
-        if (gCurrentFunction != FUNCTION_MONITOR && gCurrentFunction != FUNCTION_TRANSMIT && gCurrentFunction != FUNCTION_RECEIVE)
-            DECREMENT_AND_TRIGGER(gDualWatchCountdown_10ms, gScheduleDualWatch);
+    SCHEDULER_HoldTimer(&gBatterySaveTimer, gCurrentFunction != FUNCTION_FOREGROUND);
+    SCHEDULER_HoldTimer(&gPowerSaveTimer, gCurrentFunction != FUNCTION_POWER_SAVE);
+    SCHEDULER_HoldTimer(&gDualWatchTimer, !quiet || gEeprom.DUAL_WATCH == DUAL_WATCH_OFF);
 
 #ifdef ENABLE_NOAA
-    if (gScanStateDir == SCAN_OFF && !gCssBackgroundScan && gEeprom.DUAL_WATCH == DUAL_WATCH_OFF)
-        if (gIsNoaaMode && gCurrentFunction != FUNCTION_MONITOR && gCurrentFunction != FUNCTION_TRANSMIT)
-            if (gCurrentFunction != FUNCTION_RECEIVE)
-                DECREMENT_AND_TRIGGER(gNOAA_Countdown_10ms, gScheduleNOAA);
+    SCHEDULER_HoldTimer(&gNOAAScanTimer, !quiet || gEeprom.DUAL_WATCH != DUAL_WATCH_OFF || !gIsNoaaMode);
 #endif
 
-    if (gScanStateDir != SCAN_OFF)
-        if (gCurrentFunction != FUNCTION_MONITOR && gCurrentFunction != FUNCTION_TRANSMIT)
-            DECREMENT_AND_TRIGGER(gScanPauseDelayIn_10ms, gScheduleScanListen);
-
-    DECREMENT_AND_TRIGGER(gTailNoteEliminationCountdown_10ms, gFlagTailNoteEliminationComplete);
+    SCHEDULER_HoldTimer(&gScanPauseTimer, gScanStateDir == SCAN_OFF || busy);
 
-#ifdef ENABLE_VOICE
-    DECREMENT_AND_TRIGGER(gCountdownToPlayNextVoice_10ms, gFlagPlayQueuedVoice);
+#ifdef ENABLE_FMRADIO
+    SCHEDULER_HoldTimer(&gFmPlayTimer, gFM_ScanState == FM_SCAN_OFF || busy || rx);
 #endif
+}
 
-#ifdef ENABLE_FMRADIO
-    if (gFM_ScanState != FM_SCAN_OFF && gCurrentFunction != FUNCTION_MONITOR)
-        if (gCurrentFunction != FUNCTION_TRANSMIT && gCurrentFunction != FUNCTION_RECEIVE)
-            DECREMENT_AND_TRIGGER(gFmPlayCountdown_10ms, gScheduleFM);
+// we come here every 10ms
+void SysTick_Handler(void)
+{
+#ifdef ENABLE_FEAT_F4HWN_WFI
+    // current draw proxy: was the core asleep when the tick came in
+    if (idle)
+        idleTicks++;
+    else
+        busyTicks++;
 #endif
 
-#ifdef ENABLE_VOX
-    DECREMENT(gVoxStopCountdown_10ms);
+#ifdef ENABLE_FEAT_F4HWN_DEADLINE
+    PROFILER_CheckDeadline(gNextTimeslice);
 #endif
 
-    DECREMENT(boot_counter_10ms);
+    Tick();
 }
@@ -16,7 +16,51 @@
 #ifndef _SCHEDULER_H
 #define _SCHEDULER_H
 
+#include <stdbool.h>
+#include <stdint.h>
+
 #include "py32f0xx.h"
+#include "scheduler_timer.h"
+
+uint32_t SCHEDULER_GetTicks_10ms(void);
+uint32_t SCHEDULER_GetMicros(void);
+uint32_t SCHEDULER_GetCycles(void);
+
+void     SCHEDULER_StartTimer(SCHEDULER_Timer_t *pTimer, uint32_t Ticks_10ms);
+void     SCHEDULER_StopTimer(SCHEDULER_Timer_t *pTimer);
+void     SCHEDULER_HoldTimer(SCHEDULER_Timer_t *pTimer, bool Hold);
+uint32_t SCHEDULER_GetTimerRemaining(const SCHEDULER_Timer_t *pTimer);
+uint32_t SCHEDULER_GetNextDeadline(void);
+
+void     SCHEDULER_HoldCountdowns(void);
+
+#ifdef ENABLE_FEAT_F4HWN_WFI
+// wake up sources that are not already served by the 10ms tick
+enum {
+    SCHEDULER_EVENT_VCP_RX = 1U << 0,
+    SCHEDULER_EVENT_KEY    = 1U << 1,   // a key or the PTT woke the core up
+};
+
+void     SCHEDULER_PostEvent(uint32_t Event);
+bool     SCHEDULER_TakeEvent(uint32_t Event);
+void     SCHEDULER_Idle(void);
+uint32_t SCHEDULER_GetIdleTicks(void);
+uint32_t SCHEDULER_GetBusyTicks(void);
+
+#ifdef ENABLE_FEAT_F4HWN_STOP
+typedef struct {
+    uint32_t Stops;             // times the core went to STOP mode
+    uint32_t StopTicks;         // 10ms ticks spent there
+    uint32_t KeyWakes;          // STOPs cut short by a key or PTT
+    uint32_t WakeToRxLast_us;   // end of STOP to BK4819 RX on
+    uint32_t WakeToRxMax_us;
+} SCHEDULER_StopStats_t;
+
+extern SCHEDULER_StopStats_t gStopStats;
+
+void SCHEDULER_MarkRxOn(void);
+#endif
+#endif
 
 static void inline SCHEDULER_Enable()
 {
@@ -0,0 +1,40 @@
+/* Copyright 2025 muzkr https://github.com/muzkr
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *     Unless required by applicable law or agreed to in writing, software
+ *     distributed under the License is distributed on an "AS IS" BASIS,
+ *     WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *     See the License for the specific language governing permissions and
+ *     limitations under the License.
+ */
+
+#ifndef _SCHEDULER_TIMER_H
+#define _SCHEDULER_TIMER_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+// one shot timer, in 10ms ticks, kept in a hierarchical wheel so that the
+// SysTick handler only touches the timers that expire
+typedef struct SCHEDULER_Timer_t SCHEDULER_Timer_t;
+
+struct SCHEDULER_Timer_t {
+    SCHEDULER_Timer_t  *pNext;
+    SCHEDULER_Timer_t **ppPrev;
+    uint32_t            Expiry;
+    void              (*pCallback)(void);   // called from SysTick, may be NULL
+    volatile bool       Running;
+    bool                Held;                // out of the wheel, Expiry is the time left
+};
+
+static inline bool SCHEDULER_IsTimerRunning(const SCHEDULER_Timer_t *pTimer)
+{
+    return pTimer->Running;
+}
+
+#endif
@@ -14,108 +14,274 @@
  *     limitations under the License.
  */
 
+#include <string.h>
+
+#include "app/uart.h"
 #include "debugging.h"
 #include "driver/st7565.h"
+#if defined(ENABLE_UART)
+    #include "driver/uart.h"
+#endif
+#if defined(ENABLE_USB)
+    #include "driver/vcp.h"
+#endif
+#include "scheduler.h"
 #include "screenshot.h"
 #include "misc.h"
 
-// RAM optimization: Only keep previousFrame static (1024 bytes)
-// Build currentFrame on-the-fly and send delta blocks immediately
-static uint8_t previousFrame[1024] = {0};
-static uint8_t forcedBlock = 0;
-static uint8_t keepAlive = 10;
+// Frames are sent in the ST7565 native layout: 8 pages (the status line,
+// then the 7 frame lines) of 128 column bytes, bit 0 being the top row of
+// the page. No transpose is needed, each page is XORed with the copy the
+// host holds and the result is run length coded:
+//
+//   AA 55 03 len(2) | seq flags cost_us(2) | { page tokens... }... | 0A
+//
+// Token 0x80 | (n - 1) skips n unchanged bytes, token (n - 1) is followed by
+// n bytes to XOR in. A page is done once its 128 columns are covered and
+// unchanged pages are not sent at all. cost_us is the time spent encoding.
+//
+// The host drives the stream with command 0x0622 (type, value), sent to
+// the UART or the USB VCP: frames then go to the port it came from. Type 0
+// keeps the stream alive. A keyframe (flags bit 0) is coded against a blank
+// screen, they keep coming until the host acknowledges one with type 1,
+// then frames are deltas against the previous one. A host that sees a gap
+// in seq asks for a new keyframe with type 2.
 
-void getScreenShot(bool force)
+#define PAGES           (1 + FRAME_LINES)
+#define FRAME_MIN_10MS  5       // at most 20 frames per second
+#define KEY_RETRY_10MS  50      // unacknowledged keyframe sent again
+#define KEEPALIVE_10MS  200     // stream stops 2s after the last host message
+
+#define FLAG_KEYFRAME   0x01
+
+enum {
+    HOST_KEEPALIVE = 0,
+    HOST_ACK,
+    HOST_KEYFRAME
+};
+
+typedef struct {
+    bool (*IsBusy)(void);
+    bool (*Send)(const uint8_t *pFrame, uint16_t Size);     // whole frame or nothing
+} Sink_t;
+
+#if defined(ENABLE_UART)
+static bool UART_IsBusy(void)
 {
-    static uint8_t currentFrame[1024];  // Reused static buffer
-    uint16_t index = 0;
-    uint8_t acc = 0;
-    uint8_t bitCount = 0;
+    return false;   // frames are copied to the TX ring
+}
 
-    if (gUART_LockScreenshot > 0) {
-        gUART_LockScreenshot--;
-        return;
-    }
+// A frame that does not fit in the TX ring is not sent, unless the ring is
+// idle: a keyframe may be larger than the ring and then waits for the line.
+static bool UART_SendFrame(const uint8_t *pFrame, uint16_t Size)
+{
+    if (UART_TrySend(pFrame, Size))
+        return true;
 
-    if (UART_IsCableConnected()) {
-        keepAlive = 10;
-    }
+    if (UART_IsSending())
+        return false;
 
-    if (keepAlive > 0) {
-        if (--keepAlive == 0) return;
-    } else {
-        return;
-    }
+    UART_Send(pFrame, Size);
+    return true;
+}
 
-    // ==== Build currentFrame (exact same logic as original) ====
-    // Status line: 8 bit layers × 128 columns
-    for (uint8_t b = 0; b < 8; b++) {
-        for (uint8_t i = 0; i < 128; i++) {
-            uint8_t bit = (gStatusLine[i] >> b) & 0x01;
-            acc |= (bit << bitCount++);
-            if (bitCount == 8) {
-                currentFrame[index++] = acc;
-                acc = 0;
-                bitCount = 0;
-            }
+static const Sink_t sinkUart = { UART_IsBusy, UART_SendFrame };
+#endif
+
+#if defined(ENABLE_USB)
+// one bulk-in transfer per frame, shared with the command replies
+static bool VCP_IsBusy(void)
+{
+    return cdc_acm_data_send_busy();
+}
+
+static bool VCP_SendFrame(const uint8_t *pFrame, uint16_t Size)
+{
+    VCP_SendAsync(pFrame, Size);
+    return true;
+}
+
+static const Sink_t sinkVcp = { VCP_IsBusy, VCP_SendFrame };
+#endif
+
+// last frame sent, which is what the host shows while it is in sync
+static uint8_t       previous[PAGES][LCD_WIDTH];
+// stays untouched while a VCP transfer is reading it
+static uint8_t       frame[5 + 4 + PAGES * (1 + LCD_WIDTH + 1) + 1] __attribute__ ((aligned (4)));
+static const Sink_t *pSink;
+static bool          acked;
+static bool          dirty;
+static bool          keyRequested;
+static uint8_t       seq;
+static uint32_t      hostTick;
+static uint32_t      frameTick;
+
+static const uint8_t *GetPage(const uint8_t Page)
+{
+    return (Page == 0) ? gStatusLine : gFrameBuffer[Page - 1];
+}
+
+// worst case is 129 bytes: single zeros are kept inside literal runs, so
+// every skip token covers at least two columns
+static uint8_t *EncodePage(uint8_t *pOut, const uint8_t *pCur, const uint8_t *pRef)
+{
+    uint8_t i = 0;
+
+    while (i < LCD_WIDTH) {
+        uint8_t n = 0;
+
+        if ((pCur[i] ^ pRef[i]) == 0) {
+            while (i + n < LCD_WIDTH && (pCur[i + n] ^ pRef[i + n]) == 0)
+                n++;
+            *pOut++ = 0x80 | (n - 1);
         }
-    }
+        else {
+            uint8_t *pToken = pOut++;
+
+            while (i + n < LCD_WIDTH) {
+                const uint8_t x = pCur[i + n] ^ pRef[i + n];
+
+                if (x == 0 && (i + n + 1 == LCD_WIDTH || (pCur[i + n + 1] ^ pRef[i + n + 1]) == 0))
+                    break;
 
-    // Frame buffer: 7 lines × 8 bit layers × 128 columns
-    for (uint8_t l = 0; l < 7; l++) {
-        for (uint8_t b = 0; b < 8; b++) {
-            for (uint8_t i = 0; i < 128; i++) {
-                uint8_t bit = (gFrameBuffer[l][i] >> b) & 0x01;
-                acc |= (bit << bitCount++);
-                if (bitCount == 8) {
-                    currentFrame[index++] = acc;
-                    acc = 0;
-                    bitCount = 0;
-                }
+                *pOut++ = x;
+                n++;
             }
+            *pToken = n - 1;
         }
+
+        i += n;
     }
 
-    if (bitCount > 0)
-        currentFrame[index++] = acc;
+    return pOut;
+}
 
-    if (index != 1024)
-        return; // Frame size mismatch, abort
+static void SendFrame(const uint32_t Now)
+{
+    static const uint8_t blank[LCD_WIDTH];
 
-    // ==== Generate delta frame ====
-    uint16_t deltaLen = 0;
-    uint8_t deltaFrame[128 * 9];  // Worst case: all 128 blocks changed
+    const bool keyframe = !acked || keyRequested;
+
+    if (!dirty && !(keyframe && Now - frameTick >= KEY_RETRY_10MS))
+        return;
+
+    if (Now - frameTick < FRAME_MIN_10MS || pSink->IsBusy())
+        return;
 
-    for (uint8_t block = 0; block < 128; block++) {
-        uint8_t *cur = &currentFrame[block * 8];
-        uint8_t *prev = &previousFrame[block * 8];
+    const uint32_t start = SCHEDULER_GetCycles();
 
-        bool changed = memcmp(cur, prev, 8) != 0;
-        bool isForced = (block == forcedBlock);
-        bool fullUpdate = force;
+    uint8_t *pOut = &frame[9];
 
-        if (changed || isForced || fullUpdate) {
-            deltaFrame[deltaLen++] = block;
-            memcpy(&deltaFrame[deltaLen], cur, 8);
-            deltaLen += 8;
-            memcpy(prev, cur, 8); // Update stored frame
+    for (uint8_t page = 0; page < PAGES; page++) {
+        const uint8_t *pCur = GetPage(page);
+
+        if (keyframe) {
+            *pOut++ = page;
+            pOut    = EncodePage(pOut, pCur, blank);
+        }
+        else if (memcmp(pCur, previous[page], LCD_WIDTH) != 0) {
+            *pOut++ = page;
+            pOut    = EncodePage(pOut, pCur, previous[page]);
         }
     }
 
-    forcedBlock = (forcedBlock + 1) % 128;
+    dirty = false;
+
+    if (pOut == &frame[9])
+        return; // nothing changed after all
+
+    const uint16_t len  = pOut - &frame[5];
+    const uint32_t cost = (SCHEDULER_GetCycles() - start) / 48;   // 48MHz
+
+    frame[0] = 0xAA;
+    frame[1] = 0x55;
+    frame[2] = 0x03;
+    frame[3] = len >> 8;
+    frame[4] = len & 0xFF;
+    frame[5] = seq;
+    frame[6] = keyframe ? FLAG_KEYFRAME : 0;
+    frame[7] = (cost > 0xFFFF) ? 0xFF : cost >> 8;
+    frame[8] = (cost > 0xFFFF) ? 0xFF : cost & 0xFF;
+    *pOut++  = 0x0A;
+
+    // a frame that could not be sent stays pending and is coalesced with
+    // the next changes
+    if (!pSink->Send(frame, pOut - frame)) {
+        dirty = true;
+        return;
+    }
+
+    memcpy(previous[0], gStatusLine, LCD_WIDTH);
+    memcpy(previous[1], gFrameBuffer, sizeof(gFrameBuffer));
+
+    seq++;
+    dirty        = false;
+    keyRequested = false;
+    frameTick    = Now;
+}
+
+void SCREENSHOT_HostMessage(uint32_t Port, uint8_t Type, uint8_t Value)
+{
+    const Sink_t *pNew = NULL;
+
+    (void)Value;    // the acknowledged seq, any keyframe will do
+
+#if defined(ENABLE_UART)
+    if (Port == UART_PORT_UART)
+        pNew = &sinkUart;
+#endif
+#if defined(ENABLE_USB)
+    if (Port == UART_PORT_VCP)
+        pNew = &sinkVcp;
+#endif
+
+    if (pNew == NULL)
+        return;
+
+    // a new viewer starts from a keyframe
+    if (pNew != pSink) {
+        pSink = pNew;
+        acked = false;
+    }
 
-    if (deltaLen == 0)
-        return; // No update needed
+    hostTick = SCHEDULER_GetTicks_10ms();
 
-    // ==== Send frame ====
-    uint8_t header[5] = {
-        0xAA, 0x55, 0x02,
-        (uint8_t)(deltaLen >> 8),
-        (uint8_t)(deltaLen & 0xFF)
-    };
+    if (Type == HOST_ACK)
+        acked = true;
+    else if (Type == HOST_KEYFRAME)
+        acked = false;
+}
+
+// Apps with their own main loop (spectrum, breakout...) do not run the
+// command parser: the stream goes on as it was until they return.
+void getScreenShot(bool force)
+{
+    dirty = true;
+
+    if (force)
+        keyRequested = true;
+
+    if (pSink != NULL && gUART_LockScreenshot == 0)
+        SendFrame(SCHEDULER_GetTicks_10ms());
+}
+
+// frames held back by the rate cap or by a busy sink go out from here
+void SCREENSHOT_TimeSlice10ms(void)
+{
+    if (gUART_LockScreenshot > 0) {
+        gUART_LockScreenshot--;
+        return;
+    }
+
+    if (pSink == NULL)
+        return;
+
+    const uint32_t now = SCHEDULER_GetTicks_10ms();
+
+    if (now - hostTick >= KEEPALIVE_10MS) {
+        pSink = NULL;
+        return;
+    }
 
-    UART_Send(header, 5);
-    UART_Send(deltaFrame, deltaLen);
-    uint8_t end = 0x0A;
-    UART_Send(&end, 1);
-}
\ No newline at end of file
+    SendFrame(now);
+}
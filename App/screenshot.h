@@ -17,6 +17,11 @@
 #ifndef SCREENSHOT_H
 #define SCREENSHOT_H
 
+#include <stdbool.h>
+#include <stdint.h>
+
 void getScreenShot(bool force);
+void SCREENSHOT_HostMessage(uint32_t Port, uint8_t Type, uint8_t Value);
+void SCREENSHOT_TimeSlice10ms(void);
 
 #endif
\ No newline at end of file
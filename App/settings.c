@@ -41,11 +41,18 @@ static const uint32_t gDefaultFrequencyTable[] =
 
 EEPROM_Config_t gEeprom = { 0 };
 
+// The settings packed in a sector are read with one flash transfer into
+// Image and parsed from there, each read costs a command and an address
+// and only those of 16 bytes or more go through DMA.
 void SETTINGS_InitEEPROM(void)
 {
-    uint8_t Data[16] = {0};
+    uint8_t  Image[0x50];
+    uint8_t *Data = Image;
+
+    // 0E70..0E7F
+    PY25Q16_ReadBuffer(0x004000, Image, 16);
+
     // 0E70..0E77
-    PY25Q16_ReadBuffer(0x004000, Data, 8);
     gEeprom.CHAN_1_CALL          = IS_MR_CHANNEL(Data[0]) ? Data[0] : MR_CHANNEL_FIRST;
     gEeprom.SQUELCH_LEVEL        = (Data[1] < 10) ? Data[1] : 1;
     gEeprom.TX_TIMEOUT_TIMER     = (Data[2] > 4 && Data[2] < 180) ? Data[2] : 11;
@@ -66,7 +73,7 @@ void SETTINGS_InitEEPROM(void)
     gEeprom.MIC_SENSITIVITY      = (Data[7] <  5) ? Data[7] : 4;
 
     // 0E78..0E7F
-    PY25Q16_ReadBuffer(0x004008, Data, 8);
+    Data = Image + 8;
     gEeprom.BACKLIGHT_MAX         = (Data[0] & 0xF) <= 10 ? (Data[0] & 0xF) : 10;
     gEeprom.BACKLIGHT_MIN         = (Data[0] >> 4) < gEeprom.BACKLIGHT_MAX ? (Data[0] >> 4) : 0;
 #ifdef ENABLE_BLMIN_TMP_OFF
@@ -93,6 +100,7 @@ void SETTINGS_InitEEPROM(void)
     #endif
 
     // 0E80..0E87
+    Data = Image;
     PY25Q16_ReadBuffer(0x005000, Data, 8);
     gEeprom.ScreenChannel[0]   = IS_VALID_CHANNEL(Data[0]) ? Data[0] : (FREQ_CHANNEL_FIRST + BAND6_400MHz);
     gEeprom.ScreenChannel[1]   = IS_VALID_CHANNEL(Data[3]) ? Data[3] : (FREQ_CHANNEL_FIRST + BAND6_400MHz);
@@ -105,35 +113,12 @@ void SETTINGS_InitEEPROM(void)
     gEeprom.NoaaChannel[1] = IS_NOAA_CHANNEL(Data[7])  ? Data[7] : NOAA_CHANNEL_FIRST;
 #endif
 
-#ifdef ENABLE_FMRADIO
-    {   // 0E88..0E8F
-        struct
-        {
-            uint16_t selFreq;
-            uint8_t  selChn;
-            uint8_t  isMrMode:1;
-            uint8_t  band:2;
-            //uint8_t  space:2;
-        } __attribute__((packed)) fmCfg;
-        PY25Q16_ReadBuffer(0x006000, &fmCfg, 4);
-
-        gEeprom.FM_Band = fmCfg.band;
-        //gEeprom.FM_Space = fmCfg.space;
-        gEeprom.FM_SelectedFrequency = 
-            (fmCfg.selFreq >= BK1080_GetFreqLoLimit(gEeprom.FM_Band) && fmCfg.selFreq <= BK1080_GetFreqHiLimit(gEeprom.FM_Band)) ? 
-                fmCfg.selFreq : BK1080_GetFreqLoLimit(gEeprom.FM_Band);
-            
-        gEeprom.FM_SelectedChannel = fmCfg.selChn;
-        gEeprom.FM_IsMrMode        = fmCfg.isMrMode;
-    }
+    // FM radio settings are loaded by SETTINGS_LoadFM() when it starts
 
-    // 0E40..0E67
-    PY25Q16_ReadBuffer(0x003000, gFM_Channels, sizeof(gFM_Channels));
-    FM_ConfigureChannelState();
-#endif
+    // 0E90..0EDF
+    PY25Q16_ReadBuffer(0x007000, Image, 0x50);
 
     // 0E90..0E97
-    PY25Q16_ReadBuffer(0x007000, Data, 8);
     gEeprom.BEEP_CONTROL                 = Data[0] & 1;
     gEeprom.KEY_M_LONG_PRESS_ACTION      = ((Data[0] >> 1) < ACTION_OPT_LEN) ? (Data[0] >> 1) : ACTION_OPT_NONE;
     gEeprom.KEY_1_SHORT_PRESS_ACTION     = (Data[1] < ACTION_OPT_LEN) ? Data[1] : ACTION_OPT_MONITOR;
@@ -150,12 +135,12 @@ void SETTINGS_InitEEPROM(void)
 
     // 0E98..0E9F
     #ifdef ENABLE_PWRON_PASSWORD
-        PY25Q16_ReadBuffer(0x007000 + 0x8, Data, 8);
+        Data = Image + 0x8;
         memcpy(&gEeprom.POWER_ON_PASSWORD, Data, 4);
     #endif
 
     // 0EA0..0EA7
-    PY25Q16_ReadBuffer(0x007000 + 0x10, Data, 8);
+    Data = Image + 0x10;
     #ifdef ENABLE_VOICE
     gEeprom.VOICE_PROMPT = (Data[0] < 3) ? Data[0] : VOICE_PROMPT_ENGLISH;
     #endif
@@ -171,7 +156,7 @@ void SETTINGS_InitEEPROM(void)
     #endif
 
     // 0EA8..0EAF
-    PY25Q16_ReadBuffer(0x007000 + 0x18, Data, 8);
+    Data = Image + 0x18;
     #ifdef ENABLE_ALARM
         gEeprom.ALARM_MODE                 = (Data[0] <  2) ? Data[0] : true;
     #endif
@@ -181,7 +166,7 @@ void SETTINGS_InitEEPROM(void)
     gEeprom.BATTERY_TYPE                   = (Data[4] < BATTERY_TYPE_UNKNOWN) ? Data[4] : BATTERY_TYPE_1600_MAH;
 
     // 0ED0..0ED7
-    PY25Q16_ReadBuffer(0x007000 + 0x40, Data, 8);
+    Data = Image + 0x40;
     gEeprom.DTMF_SIDE_TONE               = (Data[0] <   2) ? Data[0] : true;
 
 #ifdef ENABLE_DTMF_CALLING
@@ -195,15 +180,19 @@ void SETTINGS_InitEEPROM(void)
     gEeprom.DTMF_HASH_CODE_PERSIST_TIME  = (Data[7] < 101) ? Data[7] * 10 : 100;
 
     // 0ED8..0EDF
-    PY25Q16_ReadBuffer(0x007000 + 0x48, Data, 8);
+    Data = Image + 0x48;
     gEeprom.DTMF_CODE_PERSIST_TIME  = (Data[0] < 101) ? Data[0] * 10 : 100;
     gEeprom.DTMF_CODE_INTERVAL_TIME = (Data[1] < 101) ? Data[1] * 10 : 100;
 #ifdef ENABLE_DTMF_CALLING
     gEeprom.PERMIT_REMOTE_KILL      = (Data[2] <   2) ? Data[2] : true;
+#endif
 
-    // 0EE0..0EE7
+    // 0EE0..0F17
+    PY25Q16_ReadBuffer(0x008000, Image, 0x38);
 
-    PY25Q16_ReadBuffer(0x008000, Data, sizeof(gEeprom.ANI_DTMF_ID));
+#ifdef ENABLE_DTMF_CALLING
+    // 0EE0..0EE7
+    Data = Image;
     if (DTMF_ValidateCodes((char *)Data, sizeof(gEeprom.ANI_DTMF_ID))) {
         memcpy(gEeprom.ANI_DTMF_ID, Data, sizeof(gEeprom.ANI_DTMF_ID));
     } else {
@@ -212,7 +201,7 @@ void SETTINGS_InitEEPROM(void)
 
 
     // 0EE8..0EEF
-    PY25Q16_ReadBuffer(0x008000 + 0x8, Data, sizeof(gEeprom.KILL_CODE));
+    Data = Image + 0x8;
     if (DTMF_ValidateCodes((char *)Data, sizeof(gEeprom.KILL_CODE))) {
         memcpy(gEeprom.KILL_CODE, Data, sizeof(gEeprom.KILL_CODE));
     } else {
@@ -220,7 +209,7 @@ void SETTINGS_InitEEPROM(void)
     }
 
     // 0EF0..0EF7
-    PY25Q16_ReadBuffer(0x008000 + 0x10, Data, sizeof(gEeprom.REVIVE_CODE));
+    Data = Image + 0x10;
     if (DTMF_ValidateCodes((char *)Data, sizeof(gEeprom.REVIVE_CODE))) {
         memcpy(gEeprom.REVIVE_CODE, Data, sizeof(gEeprom.REVIVE_CODE));
     } else {
@@ -229,7 +218,7 @@ void SETTINGS_InitEEPROM(void)
 #endif
 
     // 0EF8..0F07
-    PY25Q16_ReadBuffer(0x008000 + 0x18, Data, sizeof(gEeprom.DTMF_UP_CODE));
+    Data = Image + 0x18;
     if (DTMF_ValidateCodes((char *)Data, sizeof(gEeprom.DTMF_UP_CODE))) {
         memcpy(gEeprom.DTMF_UP_CODE, Data, sizeof(gEeprom.DTMF_UP_CODE));
     } else {
@@ -237,7 +226,7 @@ void SETTINGS_InitEEPROM(void)
     }
 
     // 0F08..0F17
-    PY25Q16_ReadBuffer(0x008000 + 0x28, Data, sizeof(gEeprom.DTMF_DOWN_CODE));
+    Data = Image + 0x28;
     if (DTMF_ValidateCodes((char *)Data, sizeof(gEeprom.DTMF_DOWN_CODE))) {
         memcpy(gEeprom.DTMF_DOWN_CODE, Data, sizeof(gEeprom.DTMF_DOWN_CODE));
     } else {
@@ -245,6 +234,7 @@ void SETTINGS_InitEEPROM(void)
     }
 
     // 0F18..0F1F
+    Data = Image;
     PY25Q16_ReadBuffer(0x009000, Data, 8);
     gEeprom.SCAN_LIST_DEFAULT = (Data[0] < 6) ? Data[0] : 0;  // we now have 'all' channel scan option
 
@@ -400,19 +390,24 @@ void SETTINGS_LoadCalibration(void)
 {
 //  uint8_t Mic;
 
+    // 0x1EC0..0x1F8F in a single read, parsed from RAM
+    #define CALIB(offset) (Image + (offset) - 0xc0)
+    uint8_t Image[0xd0];
+    PY25Q16_ReadBuffer(0x010000 + 0xc0, Image, sizeof(Image));
+
     // 0x1EC0
-    PY25Q16_ReadBuffer(0x010000 + 0xc0, gEEPROM_RSSI_CALIB[3], 8);
+    memcpy(gEEPROM_RSSI_CALIB[3], CALIB(0xc0), 8);
     memcpy(gEEPROM_RSSI_CALIB[4], gEEPROM_RSSI_CALIB[3], 8);
     memcpy(gEEPROM_RSSI_CALIB[5], gEEPROM_RSSI_CALIB[3], 8);
     memcpy(gEEPROM_RSSI_CALIB[6], gEEPROM_RSSI_CALIB[3], 8);
 
     // 0x1EC8
-    PY25Q16_ReadBuffer(0x010000 + 0xc8, gEEPROM_RSSI_CALIB[0], 8);
+    memcpy(gEEPROM_RSSI_CALIB[0], CALIB(0xc8), 8);
     memcpy(gEEPROM_RSSI_CALIB[1], gEEPROM_RSSI_CALIB[0], 8);
     memcpy(gEEPROM_RSSI_CALIB[2], gEEPROM_RSSI_CALIB[0], 8);
 
     // 0x1F40
-    PY25Q16_ReadBuffer(0x010000 + 0x140, gBatteryCalibration, 12);
+    memcpy(gBatteryCalibration, CALIB(0x140), 12);
     if (gBatteryCalibration[0] >= 5000)
     {
         gBatteryCalibration[0] = 1900;
@@ -422,9 +417,9 @@ void SETTINGS_LoadCalibration(void)
 
     #ifdef ENABLE_VOX
         // 0x1F50
-        PY25Q16_ReadBuffer(0x010000 + 0x150 + (gEeprom.VOX_LEVEL * 2), &gEeprom.VOX1_THRESHOLD, 2);
+        memcpy(&gEeprom.VOX1_THRESHOLD, CALIB(0x150 + (gEeprom.VOX_LEVEL * 2)), 2);
         // 0x1F68
-        PY25Q16_ReadBuffer(0x010000 + 0x168 + (gEeprom.VOX_LEVEL * 2), &gEeprom.VOX0_THRESHOLD, 2);
+        memcpy(&gEeprom.VOX0_THRESHOLD, CALIB(0x168 + (gEeprom.VOX_LEVEL * 2)), 2);
     #endif
 
     //PY25Q16_ReadBuffer(0x1F80 + gEeprom.MIC_SENSITIVITY, &Mic, 1);
@@ -444,7 +439,7 @@ void SETTINGS_LoadCalibration(void)
         // radio 1 .. 04 00 46 00 50 00 2C 0E
         // radio 2 .. 05 00 46 00 50 00 2C 0E
         // 0x1F88
-        PY25Q16_ReadBuffer(0x010000 + 0x188, &Misc, 8);
+        memcpy(&Misc, CALIB(0x188), 8);
 
         gEeprom.BK4819_XTAL_FREQ_LOW = (Misc.BK4819_XtalFreqLow >= -1000 && Misc.BK4819_XtalFreqLow <= 1000) ? Misc.BK4819_XtalFreqLow : 0;
         gEEPROM_1F8A                 = Misc.EEPROM_1F8A & 0x01FF;
@@ -459,8 +454,49 @@ void SETTINGS_LoadCalibration(void)
         BK4819_WriteRegister(BK4819_REG_3B, 22656 + gEeprom.BK4819_XTAL_FREQ_LOW);
 //      BK4819_WriteRegister(BK4819_REG_3C, gEeprom.BK4819_XTAL_FREQ_HIGH);
     }
+
+    #undef CALIB
 }
 
+#ifdef ENABLE_FMRADIO
+// Only the FM radio uses these, they are read the first time it starts
+// rather than at boot
+void SETTINGS_LoadFM(void)
+{
+    static bool loaded;
+
+    if (loaded)
+        return;
+
+    loaded = true;
+
+    {   // 0E88..0E8F
+        struct
+        {
+            uint16_t selFreq;
+            uint8_t  selChn;
+            uint8_t  isMrMode:1;
+            uint8_t  band:2;
+            //uint8_t  space:2;
+        } __attribute__((packed)) fmCfg;
+        PY25Q16_ReadBuffer(0x006000, &fmCfg, 4);
+
+        gEeprom.FM_Band = fmCfg.band;
+        //gEeprom.FM_Space = fmCfg.space;
+        gEeprom.FM_SelectedFrequency = 
+            (fmCfg.selFreq >= BK1080_GetFreqLoLimit(gEeprom.FM_Band) && fmCfg.selFreq <= BK1080_GetFreqHiLimit(gEeprom.FM_Band)) ? 
+                fmCfg.selFreq : BK1080_GetFreqLoLimit(gEeprom.FM_Band);
+            
+        gEeprom.FM_SelectedChannel = fmCfg.selChn;
+        gEeprom.FM_IsMrMode        = fmCfg.isMrMode;
+    }
+
+    // 0E40..0E67
+    PY25Q16_ReadBuffer(0x003000, gFM_Channels, sizeof(gFM_Channels));
+    FM_ConfigureChannelState();
+}
+#endif
+
 uint32_t SETTINGS_FetchChannelFrequency(const int channel)
 {
     struct
@@ -595,6 +631,9 @@ void SETTINGS_FactoryReset(bool bIsAll)
 #ifdef ENABLE_FMRADIO
 void SETTINGS_SaveFM(void)
     {
+        // never write back channels that were not read
+        SETTINGS_LoadFM();
+
         union {
             struct {
                 uint16_t selFreq;
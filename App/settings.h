@@ -126,6 +126,9 @@ enum ACTION_OPT_t {
 #ifdef ENABLE_REGA
     ACTION_OPT_REGA_ALARM,
     ACTION_OPT_REGA_TEST,
+#endif
+#ifdef ENABLE_FEAT_F4HWN_SCAN_LOG
+    ACTION_OPT_SCAN_LOG,
 #endif
     ACTION_OPT_LEN
 };
@@ -308,6 +311,9 @@ extern EEPROM_Config_t gEeprom;
 
 void     SETTINGS_InitEEPROM(void);
 void     SETTINGS_LoadCalibration(void);
+#ifdef ENABLE_FMRADIO
+    void SETTINGS_LoadFM(void);
+#endif
 uint32_t SETTINGS_FetchChannelFrequency(const int channel);
 void     SETTINGS_FetchChannelName(char *s, const int channel);
 void     SETTINGS_FactoryReset(bool bIsAll);
@@ -0,0 +1,91 @@
+/* Copyright 2025 Armel F4HWN
+ * https://github.com/armel
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *     Unless required by applicable law or agreed to in writing, software
+ *     distributed under the License is distributed on an "AS IS" BASIS,
+ *     WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *     See the License for the specific language governing permissions and
+ *     limitations under the License.
+ */
+
+#ifndef TASK_H
+#define TASK_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "scheduler.h"
+
+// Cooperative tasks, protothread style: a task is a function that returns
+// at each wait and resumes at the same spot on its next call, the main loop
+// calling it again on every pass. Its state must live outside the stack
+// (static or global), and waits cannot sit inside a switch of the task
+// body since the resume point is itself a case label.
+//
+//  static TASK_State_t MyTask(TASK_t *pTask)
+//  {
+//      TASK_BEGIN(pTask);
+//      ...
+//      TASK_DELAY_MS(pTask, 20);
+//      ...
+//      TASK_END(pTask);
+//  }
+
+typedef struct {
+    uint16_t Line;      // resume point, 0 when the task is not running
+    uint32_t Until_us;
+} TASK_t;
+
+typedef enum {
+    TASK_WAITING,
+    TASK_DONE
+} TASK_State_t;
+
+#define TASK_LINE_START 1
+
+#define TASK_BEGIN(t)   switch ((t)->Line) { case TASK_LINE_START:
+
+#define TASK_END(t)     } (t)->Line = 0; return TASK_DONE
+
+#define TASK_WAIT_UNTIL(t, cond)                \
+    do {                                        \
+        (t)->Line = __LINE__;                   \
+        /* fallthrough */                       \
+        case __LINE__:                          \
+        if (!(cond))                            \
+            return TASK_WAITING;                \
+    } while (0)
+
+#define TASK_DELAY_MS(t, ms)                                                \
+    do {                                                                    \
+        (t)->Until_us = SCHEDULER_GetMicros() + (uint32_t)(ms) * 1000;      \
+        TASK_WAIT_UNTIL(t, TASK_Expired(t));                                \
+    } while (0)
+
+static inline void TASK_Start(TASK_t *pTask)
+{
+    pTask->Line = TASK_LINE_START;
+}
+
+static inline void TASK_Stop(TASK_t *pTask)
+{
+    pTask->Line = 0;
+}
+
+static inline bool TASK_IsRunning(const TASK_t *pTask)
+{
+    return pTask->Line != 0;
+}
+
+static inline bool TASK_Expired(const TASK_t *pTask)
+{
+    return (int32_t)(SCHEDULER_GetMicros() - pTask->Until_us) >= 0;
+}
+
+#endif
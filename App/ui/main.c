@@ -19,6 +19,9 @@
 
 #include "app/chFrScanner.h"
 #include "app/dtmf.h"
+#ifdef ENABLE_FEAT_F4HWN_NWATCH
+    #include "app/nwatch.h"
+#endif
 #ifdef ENABLE_AM_FIX
     #include "am_fix.h"
 #endif
@@ -797,6 +800,14 @@ void UI_DisplayMain(void)
 #endif
         }
 
+#ifdef ENABLE_FEAT_F4HWN_NWATCH
+        if (vfo_num == gEeprom.RX_VFO && NWATCH_IsExtraSlot())
+        {   // an extra N-watch channel is being listened on this line
+            sprintf(String, "W%u", gRxVfo->CHANNEL_SAVE + 1);
+            UI_PrintStringSmallNormal(String, 2, 0, line + 1);
+        }
+        else
+#endif
         if (IS_MR_CHANNEL(gEeprom.ScreenChannel[vfo_num]))
         {   // channel mode
             const unsigned int x = 2;
@@ -1400,7 +1411,7 @@ void UI_DisplayMain(void)
 #endif
 
 #if defined(ENABLE_AM_FIX) && defined(ENABLE_AM_FIX_SHOW_DATA)
-        if (rx && gEeprom.VfoInfo[gEeprom.RX_VFO].Modulation == MODULATION_AM && gSetting_AM_fix)
+        if (rx && gRxVfo->Modulation == MODULATION_AM && gSetting_AM_fix)
         {
             if (gScreenToDisplay != DISPLAY_MAIN
 #ifdef ENABLE_DTMF_CALLING
@@ -469,6 +469,9 @@ const t_sidefunction gSubMenu_SIDEFUNCTIONS[] =
         {"REMOVE\nOFFSET",  ACTION_OPT_REMOVE_OFFSET},
     #endif
 #endif
+#ifdef ENABLE_FEAT_F4HWN_SCAN_LOG
+    {"SCAN\nLOG",       ACTION_OPT_SCAN_LOG},
+#endif
 };
 
 const uint8_t gSubMenu_SIDEFUNCTIONS_size = ARRAY_SIZE(gSubMenu_SIDEFUNCTIONS);
@@ -0,0 +1,74 @@
+/* Copyright 2025 Armel F4HWN
+ * https://github.com/armel
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *     Unless required by applicable law or agreed to in writing, software
+ *     distributed under the License is distributed on an "AS IS" BASIS,
+ *     WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *     See the License for the specific language governing permissions and
+ *     limitations under the License.
+ */
+
+#include <string.h>
+
+#include "app/scanlog.h"
+#include "dcs.h"
+#include "driver/st7565.h"
+#include "external/printf/printf.h"
+#include "misc.h"
+#include "settings.h"
+#include "ui/helper.h"
+#include "ui/scanlog.h"
+
+void UI_DisplayScanLog(void)
+{
+    char            String[32];
+    ScanLogRecord_t Record;
+    const uint16_t  Count = SCANLOG_GetCount();
+
+    UI_DisplayClear();
+
+    sprintf(String, "SCAN LOG %u/%u", Count ? gScanLogCursor + 1 : 0, Count);
+    UI_PrintStringSmallBold(String, 0, 127, 0);
+
+    // three records per page, two lines each, newest first
+    for (uint8_t i = 0; i < 3; i++) {
+        if (!SCANLOG_Read(gScanLogCursor + i, &Record))
+            break;
+
+        const uint8_t line = 1 + (i * 2);
+
+        if (IS_MR_CHANNEL(Record.FrqOrChan)) {
+            char Name[17] = {0};
+            SETTINGS_FetchChannelName(Name, Record.FrqOrChan);
+            Name[10] = 0;
+            sprintf(String, "M%03u %s", (unsigned int)Record.FrqOrChan + 1, Name);
+        }
+        else {
+            sprintf(String, "%3u.%05u", (unsigned int)(Record.FrqOrChan / 100000), (unsigned int)(Record.FrqOrChan % 100000));
+        }
+        UI_PrintStringSmallNormal(String, 0, 0, line);
+
+        sprintf(String, "%d", (Record.Rssi / 2) - 160);
+        UI_PrintStringSmallNormal(String, 110, 0, line);
+
+        const uint32_t t = Record.Time;
+        int            n = sprintf(String, "S%u %u:%02u:%02u %us", Record.Session,
+                                   (unsigned int)(t / 3600), (unsigned int)((t / 60) % 60), (unsigned int)(t % 60),
+                                   Record.Duration);
+
+        if (Record.CodeType == CODE_TYPE_CONTINUOUS_TONE && Record.Code < ARRAY_SIZE(CTCSS_Options))
+            sprintf(String + n, " %u.%u", CTCSS_Options[Record.Code] / 10, CTCSS_Options[Record.Code] % 10);
+        else if ((Record.CodeType == CODE_TYPE_DIGITAL || Record.CodeType == CODE_TYPE_REVERSE_DIGITAL) && Record.Code < ARRAY_SIZE(DCS_Options))
+            sprintf(String + n, " D%03o%c", DCS_Options[Record.Code], Record.CodeType == CODE_TYPE_DIGITAL ? 'N' : 'I');
+
+        UI_PrintStringSmallNormal(String, 6, 0, line + 1);
+    }
+
+    ST7565_BlitFullScreen();
+}
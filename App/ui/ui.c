@@ -24,6 +24,7 @@
 #endif
 #include "driver/keyboard.h"
 #include "misc.h"
+#include "profiler.h"
 #ifdef ENABLE_AIRCOPY
     #include "ui/aircopy.h"
 #endif
@@ -37,6 +38,9 @@
 #include "ui/main.h"
 #include "ui/menu.h"
 #include "ui/scanner.h"
+#ifdef ENABLE_FEAT_F4HWN_SCAN_LOG
+    #include "ui/scanlog.h"
+#endif
 #include "ui/ui.h"
 #include "../misc.h"
 
@@ -53,6 +57,10 @@ void (*UI_DisplayFunctions[])(void) = {
     [DISPLAY_MENU] = &UI_DisplayMenu,
     [DISPLAY_SCANNER] = &UI_DisplayScanner,
 
+#ifdef ENABLE_FEAT_F4HWN_SCAN_LOG
+    [DISPLAY_SCANLOG] = &UI_DisplayScanLog,
+#endif
+
 #ifdef ENABLE_FMRADIO
     [DISPLAY_FM] = &UI_DisplayFM,
 #endif
@@ -71,7 +79,7 @@ static_assert(ARRAY_SIZE(UI_DisplayFunctions) == DISPLAY_N_ELEM);
 void GUI_DisplayScreen(void)
 {
     if (gScreenToDisplay != DISPLAY_INVALID) {
-        UI_DisplayFunctions[gScreenToDisplay]();
+        PROFILE(PROFILER_DISPLAY, UI_DisplayFunctions[gScreenToDisplay]());
     }
 }
 
@@ -26,6 +26,10 @@ enum GUI_DisplayType_t
     DISPLAY_MENU,
     DISPLAY_SCANNER,
 
+#ifdef ENABLE_FEAT_F4HWN_SCAN_LOG
+    DISPLAY_SCANLOG,
+#endif
+
 #ifdef ENABLE_FMRADIO
     DISPLAY_FM,
 #endif
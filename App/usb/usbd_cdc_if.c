@@ -1,6 +1,10 @@
 #include "usbd_core.h"
 #include "usbd_cdc.h"
 
+#ifdef ENABLE_FEAT_F4HWN_WFI
+#include "scheduler.h"
+#endif
+
 /*!< endpoint address */
 #define CDC_IN_EP  0x81
 #define CDC_OUT_EP 0x02
@@ -101,6 +105,8 @@ volatile bool ep_tx_busy_flag = false;
 
 void usbd_configure_done_callback(void)
 {
+    ep_tx_busy_flag = false;
+
     /* setup first out ep read transfer */
     usbd_ep_start_read(CDC_OUT_EP, read_buffer, sizeof(read_buffer));
 }
@@ -129,6 +135,10 @@ void usbd_cdc_acm_bulk_out(uint8_t ep, uint32_t nbytes)
         }
 
         *rx_buf->write_pointer = pointer;
+
+#ifdef ENABLE_FEAT_F4HWN_WFI
+        SCHEDULER_PostEvent(SCHEDULER_EVENT_VCP_RX);
+#endif
     }
 
     /* setup next out ep read transfer */
@@ -199,6 +209,12 @@ void cdc_acm_data_send_with_dtr_async(const uint8_t *buf, uint32_t size)
 {
     if (0 != size)
     {
+        ep_tx_busy_flag = true;
         usbd_ep_start_write(CDC_IN_EP, buf, size);
     }
 }
+
+bool cdc_acm_data_send_busy(void)
+{
+    return ep_tx_busy_flag;
+}
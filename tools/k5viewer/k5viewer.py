@@ -13,7 +13,7 @@ import serial
 from serial.tools import list_ports
 
 # Version
-VERSION = '1.0'
+VERSION = '1.2'
 
 # Serial configuration
 DEFAULT_PORT = '/dev/ttyUSB0'  # Change if needed (/dev/cu.usbserial-11130)
@@ -28,9 +28,30 @@ FRAME_SIZE = 1024
 HEADER = b'\xAA\x55'
 TYPE_SCREENSHOT = b'\x01'
 TYPE_DIFF = b'\x02'
+TYPE_NATIVE = b'\x03'  # ST7565 pages, XOR delta + RLE
+FLAG_KEYFRAME = 0x01
+PAGE_COUNT = 8
+KEEPALIVE_PERIOD = 0.25
 
-# Framebuffer
+# Host messages, firmware command 0x0622 (type, value)
+CMD_SCREENSHOT_CONTROL = 0x0622
+HOST_KEEPALIVE = 0x00
+HOST_ACK = 0x01
+HOST_KEYFRAME = 0x02
+OBFUSCATION = bytes([0x16, 0x6C, 0x14, 0xE6, 0x2E, 0x91, 0x0D, 0x40, 0x21, 0x35, 0xD5, 0x40, 0x13, 0x03, 0xE9, 0x80])
+
+# Framebuffer, row-major bits for TYPE_SCREENSHOT/TYPE_DIFF, ST7565 pages
+# (128 column bytes each, bit 0 at the top) for TYPE_NATIVE
 framebuffer = bytearray([0] * FRAME_SIZE)
+native = False
+
+
+class StreamState:
+    def __init__(self):
+        self.synced = False     # holding the frame the radio deltas against
+        self.seq = 0
+        self.cost_us = 0
+        self.last_host_msg = 0.0
 
 
 COLOR_SETS = {  # {key: (name, foreground, background)}
@@ -42,15 +63,38 @@ COLOR_SETS = {  # {key: (name, foreground, background)}
 
 DEFAULT_COLOR = "g"  # Must be a key of "COLOR_SETS"
 
-def send_keepalive(ser: serial.Serial):
-    # Send keepalive frame
+def crc16(data: bytes) -> int:
+    crc = 0
+    for b in data:
+        crc ^= b << 8
+        for _ in range(8):
+            crc = ((crc << 1) ^ 0x1021) if crc & 0x8000 else crc << 1
+            crc &= 0xFFFF
+    return crc
+
+
+def make_packet(cmd_id: int, data: bytes) -> bytes:
+    # AB CD len | obfuscated (id len data crc) | DC BA
+    body = cmd_id.to_bytes(2, 'little') + len(data).to_bytes(2, 'little') + data
+    body += crc16(body).to_bytes(2, 'little')
+    body = bytes(b ^ OBFUSCATION[i % 16] for i, b in enumerate(body))
+    return b'\xAB\xCD' + (len(body) - 2).to_bytes(2, 'little') + body + b'\xDC\xBA'
+
+
+def send_host_msg(ser: serial.Serial, state: StreamState, msg_type: int, value: int = 0):
     try:
-        ser.write(b'\x55\xAA\x00\x00')  # Keepalive frame
+        ser.write(make_packet(CMD_SCREENSHOT_CONTROL, bytes([msg_type, value & 0xFF, 0, 0])))
+        state.last_host_msg = time.monotonic()
     except serial.SerialException:
         pass
 
-def read_frame(ser: serial.Serial) -> bytearray:
-    global framebuffer
+
+def send_keepalive(ser: serial.Serial, state: StreamState):
+    if time.monotonic() - state.last_host_msg >= KEEPALIVE_PERIOD:
+        send_host_msg(ser, state, HOST_KEEPALIVE)
+
+def read_frame(ser: serial.Serial, state: StreamState) -> bytearray:
+    global framebuffer, native
     while True:
         try:
             b = ser.read(1)
@@ -69,11 +113,21 @@ def read_frame(ser: serial.Serial) -> bytearray:
                 if t == TYPE_SCREENSHOT and size == FRAME_SIZE:
                     payload = ser.read(FRAME_SIZE)
                     framebuffer = bytearray(payload)
+                    native = False
                     return framebuffer
                 elif t == TYPE_DIFF and size % 9 == 0:
                     payload = ser.read(size)
                     framebuffer = apply_diff(framebuffer, payload)
+                    native = False
                     return framebuffer
+                elif t == TYPE_NATIVE and 4 <= size <= 4 + PAGE_COUNT * 130:
+                    payload = ser.read(size)
+                    if not native:
+                        framebuffer = bytearray(FRAME_SIZE)
+                        native = True
+                        state.synced = False
+                    if apply_native(framebuffer, payload, ser, state):
+                        return framebuffer
 
 
 def apply_diff(framebuffer: bytearray, diff_payload: bytes) -> bytearray:
@@ -88,23 +142,69 @@ def apply_diff(framebuffer: bytearray, diff_payload: bytes) -> bytearray:
     return framebuffer
 
 
+def decode_native(framebuffer: bytearray, payload: bytes):
+    i = 4
+    while i < len(payload):
+        page = payload[i]
+        i += 1
+        if page >= PAGE_COUNT:
+            raise ValueError(page)
+        base = page * WIDTH
+        col = 0
+        while col < WIDTH:
+            token = payload[i]
+            i += 1
+            run = (token & 0x7F) + 1
+            if not token & 0x80:
+                for k in range(run):
+                    framebuffer[base + col + k] ^= payload[i + k]
+                i += run
+            col += run
+        if col != WIDTH:
+            raise ValueError(col)
+
+
+def apply_native(framebuffer: bytearray, payload: bytes, ser: serial.Serial, state: StreamState) -> bool:
+    seq, flags = payload[0], payload[1]
+    keyframe = bool(flags & FLAG_KEYFRAME)
+
+    # A delta only applies on top of the frame right before it
+    if not keyframe and (not state.synced or seq != (state.seq + 1) & 0xFF):
+        state.synced = False
+        send_host_msg(ser, state, HOST_KEYFRAME)
+        return False
+
+    if keyframe:
+        framebuffer[:] = bytes(FRAME_SIZE)
+    try:
+        decode_native(framebuffer, payload)
+    except (IndexError, ValueError):
+        state.synced = False
+        send_host_msg(ser, state, HOST_KEYFRAME)
+        return False
+
+    if keyframe:
+        send_host_msg(ser, state, HOST_ACK, seq)  # Deltas follow
+    state.synced = True
+    state.seq = seq
+    state.cost_us = int.from_bytes(payload[2:4], 'big')
+    return True
+
+
 def draw_frame(screen: pygame.Surface, framebuffer: bytearray, bg_color: pygame.Color, fg_color: pygame.Color, pixel_size: int = 4, pixel_lcd: int = 0) -> pygame.Surface:
-    def get_bit(bit_idx):
-        byte_idx = bit_idx // 8
-        bit_pos = bit_idx % 8
-        if byte_idx < len(framebuffer):
-            return (framebuffer[byte_idx] >> bit_pos) & 0x01
-        return 0
+    def get_pixel(x, y):
+        if native:
+            return (framebuffer[(y // 8) * WIDTH + x] >> (y % 8)) & 0x01
+        bit_idx = y * WIDTH + x
+        return (framebuffer[bit_idx // 8] >> (bit_idx % 8)) & 0x01
 
     screen.fill(bg_color)
-    bit_index = 0
-    for y in range(64):
-        for x in range(128):
-            if get_bit(bit_index):
+    for y in range(HEIGHT):
+        for x in range(WIDTH):
+            if get_pixel(x, y):
                 px = x * (pixel_size - 1)
                 py = y * pixel_size
                 pygame.draw.rect(screen, fg_color, (px, py, pixel_size - 1 - pixel_lcd, pixel_size - pixel_lcd))
-            bit_index += 1
 
     pygame.display.flip()
     return pygame.display.get_surface().copy()
@@ -123,6 +223,7 @@ def run_viewer(args: argparse.Namespace, ser: serial.Serial):
     frame_count = 0
     frame_lost = 0
     last_time = time.monotonic()
+    state = StreamState()
 
     while True:
         for event in pygame.event.get():
@@ -159,14 +260,17 @@ def run_viewer(args: argparse.Namespace, ser: serial.Serial):
                 pressed_key = event.unicode
                 if pressed_key in COLOR_SETS.keys():
                     fg_color, bg_color = COLOR_SETS[pressed_key][1:]
-        frame = read_frame(ser)
+        frame = read_frame(ser, state)
         if frame:
             last_surface = draw_frame(screen, framebuffer, bg_color, fg_color, pixel_size, pixel_lcd)
             frame_count += 1
             now = time.monotonic()
             if now - last_time >= 1.0:
                 fps = frame_count / (now - last_time)
-                pygame.display.set_caption(f"{base_title} – FPS: {fps:>04.1f}")
+                if native:
+                    pygame.display.set_caption(f"{base_title} – FPS: {fps:>04.1f} – Encode: {state.cost_us}µs")
+                else:
+                    pygame.display.set_caption(f"{base_title} – FPS: {fps:>04.1f}")
                 frame_count = 0
                 last_time = now
                 frame_lost = 0
@@ -175,7 +279,7 @@ def run_viewer(args: argparse.Namespace, ser: serial.Serial):
             if frame_lost == 5:
                 pygame.display.set_caption(f"{base_title} – No data")
 
-        send_keepalive(ser)
+        send_keepalive(ser, state)
 
 
 def cmd_list_ports(args: argparse.Namespace):
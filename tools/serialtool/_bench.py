@@ -0,0 +1,303 @@
+# Copyright (c) 2025 Armel F4HWN
+#
+#   https://github.com/armel
+#
+# Licensed under the MIT License (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at the root of this repository.
+#
+#     Unless required by applicable law or agreed to in writing, software
+#     distributed under the License is distributed on an "AS IS" BASIS,
+#     WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+#     See the License for the specific language governing permissions and
+#     limitations under the License.
+#
+
+"""
+Command channel benchmark: round-trip latency, sustained read/write rate
+and error/retry counts, reported as JSON
+"""
+
+from serial import Serial
+from datetime import datetime
+from time import monotonic
+import platform
+import statistics
+import _link as ll
+
+_TIMEOUT = 0.5
+_RETRIES = 3
+_READ_CHUNK = 128       # largest 0x051B reply
+_WRITE_CHUNK = 128      # 8 byte multiples
+_RELOAD_AREA = (0x0F30, 0x0F40)     # writing here makes the radio reload its settings
+
+
+class Result:
+
+    def __init__(self, name: str):
+        self.name = name
+        self.rtt = []
+        self.timeouts = 0
+        self.errors = 0
+        self.retries = 0
+        self.failed = 0
+        self.bytes = 0
+        self.seconds = 0.0
+
+    def to_json(self) -> dict:
+        out = {
+            "requests": len(self.rtt),
+            "timeouts": self.timeouts,
+            "errors": self.errors,
+            "retries": self.retries,
+            "failed": self.failed,
+        }
+        if self.rtt:
+            ms = sorted(t * 1000 for t in self.rtt)
+            out["rtt_ms"] = {
+                "min": round(ms[0], 3),
+                "avg": round(statistics.fmean(ms), 3),
+                "p50": round(ms[len(ms) // 2], 3),
+                "p95": round(ms[min(len(ms) - 1, len(ms) * 95 // 100)], 3),
+                "max": round(ms[-1], 3),
+            }
+        if self.bytes:
+            out["bytes"] = self.bytes
+            out["seconds"] = round(self.seconds, 3)
+            out["bytes_per_s"] = round(self.bytes / self.seconds, 1) if self.seconds else None
+        return out
+
+
+class Benchmark:
+
+    def __init__(self, ser: Serial, args):
+        self._link = ll.Link(ser)
+        self._args = args
+        self._timestamp = 0
+        self.version = None
+        self.results: list[Result] = []
+
+    # ---- requests
+
+    def _call(self, res: Result, msg_type: int, data: bytes, resp_type: int, check) -> object:
+        """one request, retried on timeout or bad reply; the reply checked by check(msg)"""
+        for attempt in range(_RETRIES + 1):
+            if attempt:
+                res.retries += 1
+                self._link.drain()
+
+            start = monotonic()
+            msg = self._link.request(msg_type, data, resp_type, _TIMEOUT)
+            rtt = monotonic() - start
+
+            if msg is None:
+                res.timeouts += 1
+                continue
+
+            value = check(msg)
+            if value is None:
+                res.errors += 1
+                continue
+
+            res.rtt.append(rtt)
+            return value
+
+        res.failed += 1
+        return None
+
+    def _hello(self, res: Result) -> bool:
+        self._timestamp = int(datetime.now().timestamp()) & 0xFFFFFFFF
+
+        def check(msg):
+            end = msg.buf.find(b"\0", 4, 20)
+            return msg.buf[4 : 20 if end < 0 else end].decode("ascii", "replace")
+
+        ver = self._call(res, 0x0514, self._timestamp.to_bytes(4, "little"), 0x0515, check)
+        if ver is not None:
+            self.version = ver
+        return ver is not None
+
+    def _read_req(self, off: int, size: int) -> bytes:
+        return off.to_bytes(2, "little") + bytes([size, 0]) + self._timestamp.to_bytes(4, "little")
+
+    def _read(self, res: Result, off: int, size: int) -> bytes | None:
+        def check(msg):
+            if msg.get_hw_LE(4) != off or msg.buf[6] != size:
+                return None
+            return bytes(msg.buf[8 : 8 + size])
+
+        return self._call(res, 0x051B, self._read_req(off, size), 0x051C, check)
+
+    def _write(self, res: Result, off: int, data: bytes) -> bool:
+        req = off.to_bytes(2, "little") + bytes([len(data), 0]) + self._timestamp.to_bytes(4, "little") + data
+        ok = self._call(res, 0x051D, req, 0x051E, lambda msg: True if msg.get_hw_LE(4) == off else None)
+        return ok is not None
+
+    # ---- tests
+
+    def run(self) -> bool:
+        args = self._args
+
+        if args.write or args.write_burn:
+            start, end = args.write_offset, args.write_offset + args.write_size
+            if start % 8 or end % 8:
+                print("Write area must be 8 byte aligned")
+                return False
+            if start < _RELOAD_AREA[1] and end > _RELOAD_AREA[0]:
+                print(f"Write area must not overlap 0x{_RELOAD_AREA[0]:04x}-0x{_RELOAD_AREA[1]:04x}")
+                return False
+
+        self._link.drain()
+
+        res = Result("hello")
+        for _ in range(args.count):
+            if not self._hello(res):
+                break
+        self.results.append(res)
+        if not self.version:
+            print("No reply from the radio")
+            return False
+        print(f"Firmware: {self.version}")
+
+        # a single 16 byte read: latency of the smallest useful exchange
+        res = Result("read_latency")
+        for _ in range(args.count):
+            self._read(res, args.offset, 16)
+        self.results.append(res)
+
+        res = Result("read_throughput")
+        self._timed(res, lambda: self._read_region(res, args.offset, args.size))
+        self.results.append(res)
+
+        res = Result(f"read_pipelined_w{args.window}")
+        self._timed(res, lambda: self._read_pipelined(res, args.offset, args.size, args.window))
+        self.results.append(res)
+
+        if args.write or args.write_burn:
+            res = Result("write_same")
+            self._timed(res, lambda: self._write_region(res, args.write_offset, args.write_size, False))
+            self.results.append(res)
+
+        if args.write_burn:
+            res = Result("write_burn")
+            self._timed(res, lambda: self._write_region(res, args.write_offset, args.write_size, True))
+            self.results.append(res)
+
+        for res in self.results:
+            print(f"  {res.name:<22} {self._summary(res)}")
+
+        return True
+
+    def _timed(self, res: Result, fn):
+        print(f"Running {res.name}..")
+        start = monotonic()
+        fn()
+        res.seconds = monotonic() - start
+
+    def _read_region(self, res: Result, off: int, size: int):
+        end = off + size
+        while off < end:
+            n = min(_READ_CHUNK, end - off)
+            if self._read(res, off, n) is not None:
+                res.bytes += n
+            off += n
+
+    def _read_pipelined(self, res: Result, off: int, size: int, window: int):
+        """up to window tagged reads in flight, lost ones are sent again"""
+        todo = [(o, min(_READ_CHUNK, off + size - o), 0) for o in range(off, off + size, _READ_CHUNK)]
+        todo.reverse()
+        inflight = {}   # seq -> (offset, size, sent at, attempt)
+        seq = 0
+
+        while todo or inflight:
+            while todo and len(inflight) < window:
+                o, n, attempt = todo.pop()
+                self._link.send_tagged(seq, 0x051B, self._read_req(o, n))
+                inflight[seq] = (o, n, monotonic(), attempt)
+                seq = (seq + 1) & 0xFFFF
+
+            msg = self._link.recv(_TIMEOUT)
+            now = monotonic()
+
+            if msg is None:
+                res.timeouts += 1
+                # everything in flight is lost, send it again
+                for o, n, _, attempt in inflight.values():
+                    self._retry(res, todo, o, n, attempt)
+                inflight.clear()
+                continue
+
+            tagged = ll.untag(msg)
+            if tagged is None or tagged[0] not in inflight:
+                continue
+
+            tag, inner = tagged
+            o, n, sent, attempt = inflight.pop(tag)
+            if inner.get_msg_type() != 0x051C or inner.get_hw_LE(4) != o or inner.buf[6] != n:
+                res.errors += 1
+                self._retry(res, todo, o, n, attempt)
+                continue
+
+            res.rtt.append(now - sent)
+            res.bytes += n
+
+    def _retry(self, res: Result, todo: list, off: int, size: int, attempt: int):
+        if attempt >= _RETRIES:
+            res.failed += 1
+            return
+        res.retries += 1
+        todo.append((off, size, attempt + 1))
+
+    def _write_region(self, res: Result, off: int, size: int, burn: bool):
+        """write back what is there already, or its complement then the original"""
+        scratch = Result("scratch")
+        end = off + size
+        while off < end:
+            n = min(_WRITE_CHUNK, end - off)
+            data = self._read(scratch, off, n)
+            if data is None:
+                res.failed += 1
+                off += n
+                continue
+
+            if burn:
+                # the firmware skips identical 8 byte blocks, force real writes
+                if self._write(res, off, bytes(b ^ 0xFF for b in data)):
+                    res.bytes += n
+                if not self._write(res, off, data):
+                    print(f"Could not restore 0x{off:04x}, write it back from a dump!")
+                    return
+            elif self._write(res, off, data):
+                res.bytes += n
+            off += n
+
+    def _summary(self, res: Result) -> str:
+        js = res.to_json()
+        out = []
+        if "rtt_ms" in js:
+            out.append(f"rtt avg {js['rtt_ms']['avg']}ms p95 {js['rtt_ms']['p95']}ms")
+        if "bytes_per_s" in js:
+            out.append(f"{js['bytes_per_s']} B/s")
+        out.append(f"timeouts {res.timeouts} errors {res.errors} retries {res.retries} failed {res.failed}")
+        return ", ".join(out)
+
+    def to_json(self) -> dict:
+        args = self._args
+        return {
+            "tool": "serialtool bench",
+            "date": datetime.now().isoformat(timespec="seconds"),
+            "host": platform.node(),
+            "port": args.port,
+            "transport": args.transport,
+            "label": args.label,
+            "firmware": self.version,
+            "params": {
+                "count": args.count,
+                "offset": args.offset,
+                "size": args.size,
+                "window": args.window,
+                "write_offset": args.write_offset if (args.write or args.write_burn) else None,
+                "write_size": args.write_size if (args.write or args.write_burn) else None,
+            },
+            "tests": {res.name: res.to_json() for res in self.results},
+        }
@@ -0,0 +1,83 @@
+# Copyright (c) 2025 Armel F4HWN
+#
+#   https://github.com/armel
+#
+# Licensed under the MIT License (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at the root of this repository.
+#
+#     Unless required by applicable law or agreed to in writing, software
+#     distributed under the License is distributed on an "AS IS" BASIS,
+#     WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+#     See the License for the specific language governing permissions and
+#     limitations under the License.
+#
+
+"""
+Blocking request/reply helpers over the command channel
+"""
+
+from serial import Serial
+from time import monotonic, sleep
+import msg as mm
+
+MSG_TAGGED = 0x0530
+MSG_TAGGED_RESP = 0x0531
+
+
+class Link:
+
+    def __init__(self, ser: Serial):
+        self.ser = ser
+        self._rx_buf = bytearray(256)
+        self._msg_buf = bytearray()
+
+    def send(self, msg_type: int, data: bytes):
+        msg = mm.Msg.make(msg_type, len(data))
+        msg.buf[4:] = data
+        self.ser.write(mm.make_packet(msg.buf))
+        self.ser.flush()
+
+    def send_tagged(self, seq: int, msg_type: int, data: bytes):
+        # 0x0530 wraps a command, its reply comes back in a 0x0531 with the same seq
+        inner = mm.Msg.make(msg_type, len(data))
+        inner.buf[4:] = data
+        self.send(MSG_TAGGED, (seq & 0xFFFF).to_bytes(2, "little") + b"\0\0" + bytes(inner.buf))
+
+    def recv(self, timeout: float) -> mm.Msg | None:
+        end = monotonic() + timeout
+        while True:
+            msg = mm.fetch(self._msg_buf)
+            if msg:
+                return msg
+
+            len1 = self.ser.readinto(self._rx_buf)
+            if len1 > 0:
+                self._msg_buf.extend(memoryview(self._rx_buf)[:len1])
+                continue
+
+            if monotonic() >= end:
+                return None
+            sleep(0.0002)
+
+    def request(self, msg_type: int, data: bytes, resp_type: int, timeout: float = 1.0) -> mm.Msg | None:
+        self.send(msg_type, data)
+
+        end = monotonic() + timeout
+        while monotonic() < end:
+            msg = self.recv(end - monotonic())
+            if msg and msg.get_msg_type() == resp_type:
+                return msg
+
+        return None
+
+    def drain(self):
+        while self.recv(0.05):
+            pass
+
+
+def untag(msg: mm.Msg) -> tuple[int, mm.Msg] | None:
+    """(seq, inner reply) of a 0x0531"""
+    if msg.get_msg_type() != MSG_TAGGED_RESP or len(msg.buf) < 12:
+        return None
+    return msg.get_hw_LE(4), mm.Msg(msg.buf[8:])
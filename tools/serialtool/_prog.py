@@ -16,19 +16,56 @@
 
 from serial import Serial
 import msg as mm
+import _link as ll
+from collections import deque
 from datetime import datetime
+from time import monotonic
+import json
 import math
+import os
 
 
 _QUIT = "quit"
 
+_PAGE_SIZE = 256
+_PAGE_TIMEOUT = 1.0     # s, pages in flight sent again after that
+_LOST_TIMEOUT = 5.0     # s without any reply: wait for the device again
+_MAX_ERRORS = 5         # error replies for the same page before giving up
+_SAVE_EVERY = 16        # acknowledged pages between progress file updates
+
+MSG_FW_CRC = 0x062C
+MSG_FW_CRC_RESP = 0x062D
+_CRC_CHUNK = 0x1000
+
 
 class Programmer:
 
-    def __init__(self, ser: Serial, fw_image: bytes, bl_ver: str):
+    def __init__(
+        self,
+        ser: Serial,
+        fw_image: bytes,
+        bl_ver: str,
+        window: int = 1,
+        skip_blank: bool = False,
+        progress_file: str | None = None,
+        resume: bool = False,
+        verify: bool = False,
+    ):
         self._ser = ser
         self._fw_image = fw_image
         self.bl_ver = bl_ver
+        self.window = max(1, window)
+        self.skip_blank = skip_blank
+        self.verify = verify
+        self.programmed = False
+        self.ok = False
+        self.progress = Progress(progress_file, fw_image)
+        if resume and self.progress.load():
+            print(
+                "Resuming: {} / {} pages already programmed".format(
+                    len(self.progress.done), self.progress.page_cnt
+                )
+            )
         self._state = _Init(self)
         # self._state = _Logging(self)
 
@@ -42,6 +79,54 @@ class Programmer:
 
         return True
 
+    def stop(self):
+        """keep what was done for a later --resume"""
+        if not self.programmed:
+            self.progress.save()
+
+
+class Progress:
+    """Pages the bootloader acknowledged, kept in a file so that an interrupted
+    run can go on where it stopped. The file is bound to the image by its CRC."""
+
+    def __init__(self, path: str | None, image: bytes):
+        self.path = path
+        self.size = len(image)
+        self.crc = mm.crc16(image)
+        self.page_cnt = math.ceil(self.size / _PAGE_SIZE)
+        self.x4 = None
+        self.done: set[int] = set()
+
+    def load(self) -> bool:
+        if not self.path or not os.path.exists(self.path):
+            print("No progress file to resume from, starting over")
+            return False
+
+        try:
+            with open(self.path) as f:
+                js = json.load(f)
+            if js["size"] != self.size or js["crc"] != self.crc:
+                print("Progress file '{}' is for another image, starting over".format(self.path))
+                return False
+            self.x4 = js["x4"]
+            self.done = set(js["done"])
+        except (OSError, ValueError, KeyError) as e:
+            print("Cannot read progress file '{}': {}".format(self.path, e))
+            return False
+
+        return True
+
+    def save(self):
+        if not self.path or not self.done:
+            return
+        js = {"size": self.size, "crc": self.crc, "x4": self.x4, "done": sorted(self.done)}
+        with open(self.path, "w") as f:
+            json.dump(js, f)
+
+    def remove(self):
+        if self.path and os.path.exists(self.path):
+            os.remove(self.path)
+
 
 class _MsgReceiver:
 
@@ -216,68 +301,150 @@ class _Handshake(_State):
 
 
 class _ProgFw(_State):
+    """Up to window pages in flight. Pages in flight too long are all sent
+    again (go-back-N), the last page goes alone once every other page is
+    acknowledged since the bootloader may start the firmware on it."""
 
     def __init__(self, prog):
         super().__init__(prog)
 
         img = prog._fw_image
-        img_len = len(img)
-        page_cnt = math.ceil(img_len / 256)
+        progress = prog.progress
+        if progress.x4 is None:
+            progress.x4 = 0xFFFFFFFF & _timestamp()
 
         self.image = img
-        self.x4 = 0xFFFFFFFF & _timestamp()
-        self.page_index = 0
-        self.page_cnt = page_cnt
-        self.expect_resp = False
+        self.x4 = progress.x4
+        self.page_cnt = progress.page_cnt
+        self.last_page = self.page_cnt - 1
+
+        todo = []
+        skipped = 0
+        for i in range(self.last_page):
+            if i in progress.done:
+                continue
+            if prog.skip_blank and self.is_blank(i):
+                skipped += 1
+                continue
+            todo.append(i)
+
+        if skipped:
+            print("Skipping {} blank pages".format(skipped))
+
+        self.todo = deque(todo)
+        self.pending = len(todo) + (0 if self.last_page in progress.done else 1)
+        self.inflight = {}  # page index -> time sent
+        self.errors = {}
+        self.acked = 0
+        self.resent = 0
+        self.start = monotonic()
+        self.last_rx = self.start
 
     def loop(self) -> _State | None:
 
-        if not self.expect_resp:
-
-            print(
-                "Programming page {} / {}..".format(self.page_index + 1, self.page_cnt)
-            )
+        prog = self.prog
+        progress = prog.progress
+        now = monotonic()
 
-            msg = self.make_msg(self.page_index)
-            self.send_msg(msg)
+        while self.todo and len(self.inflight) < prog.window:
+            self.send_page(self.todo.popleft(), now)
 
-            self.expect_resp = True
-            return None
+        if (
+            not self.todo
+            and not self.inflight
+            and self.last_page not in progress.done
+        ):
+            self.send_page(self.last_page, now)
 
         # ------------
-        #  Receive response
+        #  Receive responses
 
         msg = self.recv_msg()
         if not msg:
-            return None
+            return self.check_timeouts(now)
 
         if mm.MSG_PROG_FW_RESP != msg.get_msg_type():
             return None
 
         assert 8 == msg.get_data_len()
 
-        x4 = msg.get_word_LE(4)
+        self.last_rx = now
         page_index = msg.get_hw_LE(8)
         err = msg.get_hw_LE(10)
 
+        if page_index not in self.inflight:
+            return None  # answer to a page sent again
+
+        del self.inflight[page_index]
+
         if 0 != err:
             print(
                 "Programming failed: err = {}, page index = {}".format(err, page_index)
             )
+            n = self.errors.get(page_index, 0) + 1
+            self.errors[page_index] = n
+            if n >= _MAX_ERRORS:
+                print("Giving up on page {}".format(page_index))
+                prog.stop()
+                return _QUIT
             # Retry
-            self.expect_resp = False
+            self.todo.appendleft(page_index)
             return None
 
-        self.page_index += 1
-        self.expect_resp = False
+        progress.done.add(page_index)
+        self.acked += 1
+        print("Programmed page {} ({} / {})".format(page_index + 1, self.acked, self.pending))
+
+        if 0 == self.acked % _SAVE_EVERY:
+            progress.save()
 
-        if self.page_index < self.page_cnt:
+        if self.last_page not in progress.done:
             return None
 
-        print("Firmware program done")
+        elapsed = monotonic() - self.start
+        print(
+            "Firmware program done: {} pages in {:.1f}s, {} sent again".format(
+                self.acked, elapsed, self.resent
+            )
+        )
+        progress.remove()
+        prog.programmed = True
+        prog.ok = True
+
+        if prog.verify:
+            return _Verify(prog)
+
         # return _Logging(self.prog)
         return _QUIT
 
+    def check_timeouts(self, now: float) -> _State | None:
+
+        if now - self.last_rx > _LOST_TIMEOUT:
+            print("No answer from the device, waiting for it again..")
+            self.prog.progress.save()
+            return _Init(self.prog)
+
+        late = [i for i, sent in self.inflight.items() if now - sent > _PAGE_TIMEOUT]
+        if not late:
+            return None
+
+        # a late page means the window was lost somewhere: send all of it again, in order
+        again = sorted(self.inflight)
+        self.inflight.clear()
+        self.todo.extendleft(reversed(again))
+        self.resent += len(again)
+        return None
+
+    def send_page(self, page_index: int, now: float):
+        if not self.inflight:
+            self.last_rx = now
+        self.send_msg(self.make_msg(page_index))
+        self.inflight[page_index] = now
+
+    def is_blank(self, page_index: int) -> bool:
+        page = self.image[page_index * _PAGE_SIZE : (page_index + 1) * _PAGE_SIZE]
+        return page.count(0xFF) == len(page)
+
     def make_msg(self, page_index: int):
 
         msg: mm.Msg = mm.Msg.make(mm.MSG_PROG_FW, 268)
@@ -285,11 +452,11 @@ class _ProgFw(_State):
         msg.set_hw_LE(8, page_index)
         msg.set_hw_LE(10, self.page_cnt)
 
-        image_off = page_index * 256
+        image_off = page_index * _PAGE_SIZE
         len1 = len(self.image) - image_off
 
-        if len1 > 256:
-            len1 = 256
+        if len1 > _PAGE_SIZE:
+            len1 = _PAGE_SIZE
 
         if len1 > 0:
             # msg.set_data(self.image, page_index * 256, len1)
@@ -301,6 +468,56 @@ class _ProgFw(_State):
         return msg
 
 
+class _Verify(_State):
+    """Once the new firmware runs, compare the CRC of each 4K of the image
+    with what it reads back from its own flash (command 0x062C)"""
+
+    _BOOT_TIMEOUT = 15.0
+
+    def __init__(self, prog):
+        super().__init__(prog)
+        self.link = ll.Link(prog._ser)
+        self.deadline = monotonic() + _Verify._BOOT_TIMEOUT
+        print("Waiting for the firmware to start (power cycle the radio if it does not)..")
+
+    def loop(self) -> _State | None:
+
+        prog = self.prog
+        ts = (0xFFFFFFFF & int(datetime.now().timestamp())).to_bytes(4, "little")
+        if not self.link.request(0x0514, ts, 0x0515, 0.5):
+            if monotonic() < self.deadline:
+                return None
+            print("Firmware did not answer, not verified")
+            return _QUIT
+
+        img = prog._fw_image
+        bad = []
+        for off in range(0, len(img), _CRC_CHUNK):
+            chunk = img[off : off + _CRC_CHUNK]
+            req = off.to_bytes(4, "little") + len(chunk).to_bytes(2, "little") + b"\0\0"
+            for _ in range(3):
+                msg = self.link.request(MSG_FW_CRC, req, MSG_FW_CRC_RESP, 0.5)
+                if msg:
+                    break
+            else:
+                print("Firmware does not support CRC readback, not verified")
+                return _QUIT
+            if msg.get_hw_LE(8) != len(chunk) or msg.get_hw_LE(10) != mm.crc16(chunk):
+                bad.append(off)
+
+        if bad:
+            prog.ok = False
+            print(
+                "Verify FAILED at {}".format(", ".join("0x{:05x}".format(off) for off in bad))
+            )
+            if prog.skip_blank:
+                print("The bootloader may not erase skipped pages, flash again without --skip-blank")
+        else:
+            print("Verify OK, CRC 0x{:04x}".format(mm.crc16(img)))
+
+        return _QUIT
+
+
 def _timestamp() -> int:
     return int(datetime.now().timestamp() * 100)
 
@@ -0,0 +1,111 @@
+# Copyright (c) 2025 Armel F4HWN
+#
+#   https://github.com/armel
+#
+# Licensed under the MIT License (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at the root of this repository.
+#
+#     Unless required by applicable law or agreed to in writing, software
+#     distributed under the License is distributed on an "AS IS" BASIS,
+#     WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+#     See the License for the specific language governing permissions and
+#     limitations under the License.
+#
+
+"""
+Remote keypad: key presses injected over the command channel
+(firmware built with ENABLE_FEAT_F4HWN_REMOTE_KEYS)
+"""
+
+from serial import Serial
+from time import sleep
+import _link as ll
+
+MSG_INJECT_KEY = 0x0624
+MSG_INJECT_KEY_RESP = 0x0625
+MSG_KEY_TIMING = 0x0626
+MSG_KEY_TIMING_RESP = 0x0627
+
+# the radio releases the PTT 5s after the last command, longer holds are renewed
+_PTT_MAX_HOLD = 500
+_PTT_RENEW = 200
+
+# KEY_Code_t
+KEYS = {
+    "0": 0, "1": 1, "2": 2, "3": 3, "4": 4,
+    "5": 5, "6": 6, "7": 7, "8": 8, "9": 9,
+    "MENU": 10, "UP": 11, "DOWN": 12, "EXIT": 13,
+    "STAR": 14, "F": 15, "PTT": 16, "SIDE2": 17, "SIDE1": 18,
+}
+
+
+def key_code(name: str) -> int | None:
+    return KEYS.get(name.upper())
+
+
+class RemoteKeys:
+
+    def __init__(self, ser: Serial, keys: list[int], hold_ms: int, gap_ms: int, timing: bool):
+        self._keys = keys
+        self._hold = max(1, hold_ms // 10)
+        self._gap = gap_ms / 1000
+        self._timing = timing
+        self._index = 0
+        self._link = ll.Link(ser)
+
+    def loop(self) -> bool:
+        if self._index >= len(self._keys):
+            return False
+
+        key = self._keys[self._index]
+        self._index += 1
+
+        if key == KEYS["PTT"]:
+            # renewed while there is more than one renewal left
+            left = self._hold
+            while left > _PTT_RENEW:
+                if not self._press(key, min(left, _PTT_MAX_HOLD)):
+                    return False
+                sleep(_PTT_RENEW / 100)
+                left -= _PTT_RENEW
+            if not self._press(key, left):
+                return False
+            sleep(left / 100 + self._gap)
+            return True
+
+        if not self._press(key, self._hold):
+            return False
+
+        # the press, its handling and the screen update all happen within the hold
+        sleep(self._hold / 100 + self._gap)
+
+        if self._timing:
+            self._print_timing(key)
+
+        return True
+
+    def _press(self, key: int, hold: int) -> bool:
+        resp = self._link.request(MSG_INJECT_KEY, bytes([key, 0]) + hold.to_bytes(2, "little"), MSG_INJECT_KEY_RESP)
+        if not resp:
+            print("No reply, is the firmware built with remote keys?")
+            return False
+        if not resp.buf[8]:
+            print("Key {} rejected, is the radio locked?".format(key))
+            return False
+        return True
+
+    def _print_timing(self, key: int):
+        resp = self._link.request(MSG_KEY_TIMING, b"", MSG_KEY_TIMING_RESP)
+        if not resp:
+            return
+
+        queued = resp.get_word_LE(4)
+        pressed = resp.get_word_LE(8)
+        drawn = resp.get_word_LE(12)
+
+        line = "key {:>2}:".format(key)
+        line += " handled +{:.1f}ms".format((pressed - queued) / 1000) if pressed else " not handled"
+        if drawn:
+            line += ", drawn +{:.1f}ms".format((drawn - queued) / 1000)
+        print(line)
@@ -0,0 +1,206 @@
+# Copyright (c) 2025 Armel F4HWN
+#
+#   https://github.com/armel
+#
+# Licensed under the MIT License (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at the root of this repository.
+#
+#     Unless required by applicable law or agreed to in writing, software
+#     distributed under the License is distributed on an "AS IS" BASIS,
+#     WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+#     See the License for the specific language governing permissions and
+#     limitations under the License.
+#
+
+"""
+Differential codeplug sync: the radio hashes its EEPROM per block (0x062E),
+only the blocks that differ from the local dump are transferred
+"""
+
+from serial import Serial
+from datetime import datetime
+from time import monotonic
+import msg as mm
+import _link as ll
+
+MSG_EEPROM_CRC = 0x062E
+MSG_EEPROM_CRC_RESP = 0x062F
+
+_MAX_BLOCKS = 32        # per 0x062E request
+_MAX_BYTES = 0x2000
+_CHUNK = 128            # 0x051B / 0x051D payload
+_RELOAD_AREA = (0x0F30, 0x0F40)     # written last, the radio reloads its settings
+_TIMEOUT = 1.0
+_RETRIES = 3
+
+
+class Sync:
+
+    def __init__(self, ser: Serial, offset: int, size: int, block: int):
+        self._link = ll.Link(ser)
+        self.offset = offset
+        self.size = size
+        self.block = block
+        self._timestamp = 0
+        self.version = None
+        self.bytes = 0
+
+    def _request(self, msg_type: int, data: bytes, resp_type: int, check):
+        for _ in range(_RETRIES):
+            msg = self._link.request(msg_type, data, resp_type, _TIMEOUT)
+            if msg and check(msg):
+                return msg
+            self._link.drain()
+        return None
+
+    def connect(self) -> bool:
+        self._timestamp = int(datetime.now().timestamp()) & 0xFFFFFFFF
+        msg = self._request(0x0514, self._timestamp.to_bytes(4, "little"), 0x0515, lambda m: True)
+        if not msg:
+            print("No reply from the radio")
+            return False
+
+        end = msg.buf.find(b"\0", 4, 20)
+        self.version = msg.buf[4 : 20 if end < 0 else end].decode("ascii", "replace")
+        print("Device info: version = '{}'".format(self.version))
+        return True
+
+    def radio_crcs(self) -> list[int] | None:
+        """CRC of each block of the area, computed by the radio"""
+        crcs = []
+        per_req = max(1, min(_MAX_BLOCKS, _MAX_BYTES // self.block))
+        off = self.offset
+        end = self.offset + self.size
+
+        while off < end:
+            count = min(per_req, (end - off) // self.block)
+            req = (
+                off.to_bytes(2, "little")
+                + self.block.to_bytes(2, "little")
+                + bytes([count, 0, 0, 0])
+                + self._timestamp.to_bytes(4, "little")
+            )
+            msg = self._request(
+                MSG_EEPROM_CRC, req, MSG_EEPROM_CRC_RESP, lambda m: m.get_hw_LE(4) == off
+            )
+            if not msg:
+                print("Firmware does not support EEPROM hashes (0x062E)")
+                return None
+            if msg.buf[8] != count:
+                print("Radio refused to hash 0x{:04x} (locked?)".format(off))
+                return None
+
+            crcs.extend(msg.get_hw_LE(12 + 2 * i) for i in range(count))
+            off += count * self.block
+
+        return crcs
+
+    def diff(self, image: bytes) -> list[int] | None:
+        """offsets of the blocks where the radio and image differ"""
+        crcs = self.radio_crcs()
+        if crcs is None:
+            return None
+
+        changed = []
+        for i, crc in enumerate(crcs):
+            rel = i * self.block
+            if crc != mm.crc16(image[rel : rel + self.block]):
+                changed.append(self.offset + rel)
+        return changed
+
+    def read(self, off: int, size: int) -> bytes | None:
+        data = bytearray()
+        end = off + size
+        while off < end:
+            n = min(_CHUNK, end - off)
+            req = off.to_bytes(2, "little") + bytes([n, 0]) + self._timestamp.to_bytes(4, "little")
+            msg = self._request(0x051B, req, 0x051C, lambda m: m.get_hw_LE(4) == off and m.buf[6] == n)
+            if not msg:
+                print("Cannot read 0x{:04x}".format(off))
+                return None
+            data.extend(msg.buf[8 : 8 + n])
+            self.bytes += n
+            off += n
+        return bytes(data)
+
+    def write(self, off: int, data: bytes) -> bool:
+        # the reload area goes last, alone, as restore does
+        chunks = []
+        for rel in range(0, len(data), _CHUNK):
+            chunks.append((off + rel, data[rel : rel + _CHUNK]))
+        chunks.sort(key=lambda c: c[0] < _RELOAD_AREA[1] and c[0] + len(c[1]) > _RELOAD_AREA[0])
+
+        for o, chunk in chunks:
+            req = (
+                o.to_bytes(2, "little")
+                + bytes([len(chunk), 1])  # allow password
+                + self._timestamp.to_bytes(4, "little")
+                + chunk
+            )
+            if not self._request(0x051D, req, 0x051E, lambda m: m.get_hw_LE(4) == o):
+                print("Cannot write 0x{:04x}".format(o))
+                return False
+            self.bytes += len(chunk)
+        return True
+
+    def reboot(self):
+        self._link.send(0x05DD, b"")
+
+
+def _blocks_str(blocks: list[int]) -> str:
+    return " ".join("{:04x}".format(b) for b in blocks)
+
+
+def push(sync: Sync, image: bytes, dry_run: bool, reboot: bool) -> bool:
+    """make the radio match image"""
+    start = monotonic()
+    changed = sync.diff(image)
+    if changed is None:
+        return False
+
+    print("{} / {} blocks differ: {}".format(len(changed), sync.size // sync.block, _blocks_str(changed)))
+    if not changed or dry_run:
+        return True
+
+    # one area write per changed block, the reload area last
+    changed.sort(key=lambda b: b < _RELOAD_AREA[1] and b + sync.block > _RELOAD_AREA[0])
+    for off in changed:
+        rel = off - sync.offset
+        if not sync.write(off, image[rel : rel + sync.block]):
+            return False
+
+    left = sync.diff(image)
+    if left is None:
+        return False
+    if left:
+        print("Still different after writing: {}".format(_blocks_str(left)))
+        return False
+
+    print("Synced {} bytes in {:.2f}s".format(sync.bytes, monotonic() - start))
+    if reboot:
+        print("Rebooting device..")
+        sync.reboot()
+    return True
+
+
+def pull(sync: Sync, image: bytearray, dry_run: bool) -> bool:
+    """make image match the radio"""
+    start = monotonic()
+    changed = sync.diff(image)
+    if changed is None:
+        return False
+
+    print("{} / {} blocks differ: {}".format(len(changed), sync.size // sync.block, _blocks_str(changed)))
+    if dry_run:
+        return True
+
+    for off in changed:
+        data = sync.read(off, sync.block)
+        if data is None:
+            return False
+        rel = off - sync.offset
+        image[rel : rel + sync.block] = data
+
+    print("Read {} bytes in {:.2f}s".format(sync.bytes, monotonic() - start))
+    return True
@@ -19,12 +19,16 @@
 import argparse
 import serial
 import signal
+import json
 from time import sleep
 import os
 
 import _prog as pp
 import _dump as dd
 import _restore as rr
+import _remote as rk
+import _bench as bb
+import _sync as sy
 
 
 def load_image(file: str) -> bytes:
@@ -133,19 +137,117 @@ def main_flash(args, ser: serial.Serial):
 
     signal.signal(signal.SIGINT, quit_handler)
 
-    prog = pp.Programmer(ser, fw_image, bl_ver)
+    prog = pp.Programmer(
+        ser,
+        fw_image,
+        bl_ver,
+        window=args.window,
+        skip_blank=args.skip_blank,
+        progress_file=fw_file + ".progress",
+        resume=args.resume,
+        verify=not args.no_verify,
+    )
+
+    try:
+        while (not quit_flag) and prog.loop():
+            sleep(0)
+    except serial.SerialException as e:
+        print("Connection lost: {}".format(e))
+
+    prog.stop()
+    if not prog.programmed:
+        print("Not finished, run again with --resume to go on")
+
+
+def main_key(args, ser: serial.Serial):
+
+    keys = []
+    for name in args.keys:
+        code = rk.key_code(name)
+        if code is None:
+            print("Unknown key '{}', one of: {}".format(name, " ".join(rk.KEYS)))
+            return
+        keys.append(code)
+
+    quit_flag = False
+
+    def quit_handler(sig, frame):
+        nonlocal quit_flag
+        quit_flag = True
 
-    while (not quit_flag) and prog.loop():
+    signal.signal(signal.SIGINT, quit_handler)
+
+    remote = rk.RemoteKeys(ser, keys, args.hold, args.gap, args.timing)
+    while (not quit_flag) and remote.loop():
         sleep(0)
 
 
+def main_sync(args, ser: serial.Serial):
+
+    if args.config:
+        off, size = 0, 0x1E00
+    elif args.calib:
+        off, size = 0x1E00, 0x2000 - 0x1E00
+    else:
+        off, size = 0, 0x2000
+
+    block: int = args.block
+    if block <= 0 or block % 8 or size % block:
+        print("Invalid block size {}: a multiple of 8 dividing 0x{:x}".format(block, size))
+        return
+
+    dump_file: str = args.file
+    if os.path.exists(dump_file):
+        image = bytearray(load_image(dump_file))
+    elif args.pull:
+        image = bytearray(b"\xff" * size)
+    else:
+        print("Cannot load dump file '{}'".format(dump_file))
+        return
+
+    if len(image) != size:
+        print("Dump file size error: expect {} actually {}".format(size, len(image)))
+        return
+
+    sync = sy.Sync(ser, off, size, block)
+    if not sync.connect():
+        return
+
+    if not args.pull:
+        sy.push(sync, image, args.dry_run, not args.no_reboot)
+        return
+
+    if sy.pull(sync, image, args.dry_run) and not args.dry_run:
+        with open(dump_file, "wb") as f:
+            f.write(image)
+        print("Data successfully saved to " + dump_file)
+
+
+def main_bench(args, ser: serial.Serial):
+
+    bench = bb.Benchmark(ser, args)
+    if not bench.run():
+        return
+
+    report = json.dumps(bench.to_json(), indent=2)
+    if args.json:
+        with open(args.json, "w") as f:
+            f.write(report + "\n")
+        print("Report written to '{}'".format(args.json))
+    else:
+        print(report)
+
+
 def main():
 
     # Usage:
     # serialtool.py --port <port> subcmd ..
-    # serialtool.py .. flash [--bl-ver <ver>] <file>
+    # serialtool.py .. flash [--bl-ver <ver>] [--window <n>] [--skip-blank] [--resume] [--no-verify] <file>
     # serialtool.py .. dump {--config | --calib [| --all]} file
     # serialtool.py .. restore {--config | --calib [| --all]} file
+    # serialtool.py .. key [--hold <ms>] [--gap <ms>] [--timing] key..
+    # serialtool.py .. sync {--config | --calib [| --all]} [--pull] [--block <n>] [--dry-run] file
+    # serialtool.py .. bench [--count <n>] [--window <n>] [--write | --write-burn] [--json <file>]
     ap = argparse.ArgumentParser(description="UV-K5 V2 serial tool")
 
     # TODO: have to add option to each of subcommands ??
@@ -164,6 +266,24 @@ def main():
         required=False,
         default="?",
     )
+    ap_flash.add_argument(
+        "--window", type=int, default=2, help="pages in flight. Default 2, 1 waits for each page"
+    )
+    ap_flash.add_argument(
+        "--skip-blank",
+        action="store_true",
+        help="do not send pages that are all 0xFF. Only if the bootloader erases the whole area",
+    )
+    ap_flash.add_argument(
+        "--resume",
+        action="store_true",
+        help="only send the pages a previous interrupted run did not get acknowledged",
+    )
+    ap_flash.add_argument(
+        "--no-verify",
+        action="store_true",
+        help="do not check the CRC of the flashed firmware once it runs",
+    )
     ap_flash.add_argument("file", help="firmware image file")
 
     ap_dump = sp.add_parser("dump", help="dump configuration or calibration data")
@@ -198,6 +318,99 @@ def main():
     )
     ap_restore.add_argument("file", help="input dump file")
 
+    ap_key = sp.add_parser("key", help="press keys remotely")
+    ap_key.add_argument(
+        "--port", "-p", help="serial port, eg., '/dev/ttyUSB0'", required=True
+    )
+    ap_key.add_argument(
+        "--hold", type=int, default=100, help="press duration in ms. Default 100"
+    )
+    ap_key.add_argument(
+        "--gap", type=int, default=200, help="pause between keys in ms. Default 200"
+    )
+    ap_key.add_argument(
+        "--timing",
+        action="store_true",
+        help="print when each press was handled and drawn, relative to the command",
+    )
+    ap_key.add_argument(
+        "keys", nargs="+", help="0-9, MENU, UP, DOWN, EXIT, STAR, F, PTT, SIDE1, SIDE2"
+    )
+
+    ap_sync = sp.add_parser(
+        "sync", help="write (or with --pull read) only the EEPROM blocks that differ"
+    )
+    ap_sync.add_argument(
+        "--port", "-p", help="serial port, eg., '/dev/ttyUSB0'", required=True
+    )
+    ag = ap_sync.add_mutually_exclusive_group()
+    ag.add_argument("--config", action="store_true", help="sync configuration")
+    ag.add_argument("--calib", action="store_true", help="sync calibration data")
+    ag.add_argument(
+        "--all",
+        "-a",
+        action="store_true",
+        help="sync both configuration and calibration data. This is default",
+    )
+    ap_sync.add_argument(
+        "--pull", action="store_true", help="update the file from the radio instead"
+    )
+    ap_sync.add_argument(
+        "--block", type=lambda x: int(x, 0), default=256, help="block size in bytes. Default 256"
+    )
+    ap_sync.add_argument(
+        "--dry-run", action="store_true", help="only list the blocks that differ"
+    )
+    ap_sync.add_argument(
+        "--no-reboot", action="store_true", help="do not reboot the radio after writing"
+    )
+    ap_sync.add_argument("file", help="dump file, as written by dump")
+
+    ap_bench = sp.add_parser("bench", help="measure command channel latency and throughput")
+    ap_bench.add_argument(
+        "--port",
+        "-p",
+        help="serial port or pyserial URL, eg., '/dev/ttyACM0', 'socket://localhost:7000'",
+        required=True,
+    )
+    ap_bench.add_argument(
+        "--transport",
+        choices=["uart", "usb", "sim"],
+        default="uart",
+        help="what the port is, recorded in the report. Default uart",
+    )
+    ap_bench.add_argument("--label", default="", help="free text recorded in the report")
+    ap_bench.add_argument(
+        "--count", type=int, default=100, help="requests per latency test. Default 100"
+    )
+    ap_bench.add_argument(
+        "--window", type=int, default=4, help="tagged reads in flight. Default 4"
+    )
+    ap_bench.add_argument(
+        "--offset", type=lambda x: int(x, 0), default=0x0000, help="EEPROM area to read. Default 0x0000"
+    )
+    ap_bench.add_argument(
+        "--size", type=lambda x: int(x, 0), default=0x2000, help="bytes to read. Default 0x2000"
+    )
+    ag = ap_bench.add_mutually_exclusive_group()
+    ag.add_argument(
+        "--write",
+        action="store_true",
+        help="write back the data read, the radio skips identical blocks: protocol cost only",
+    )
+    ag.add_argument(
+        "--write-burn",
+        action="store_true",
+        help="also write the complement then the original of each block: real EEPROM writes",
+    )
+    ap_bench.add_argument(
+        "--write-offset", type=lambda x: int(x, 0), default=0x0000, help="EEPROM area to write. Default 0x0000"
+    )
+    ap_bench.add_argument(
+        "--write-size", type=lambda x: int(x, 0), default=0x0400, help="bytes to write. Default 0x0400"
+    )
+    ap_bench.add_argument("--json", help="write the report to this file instead of stdout")
+
     args = ap.parse_args()
     port: str = args.port
     sub_name: str = args.subcommand
@@ -206,7 +419,8 @@ def main():
     # print("Press Ctrl-C to quit")
 
     try:
-        ser = serial.Serial(port, baudrate=38400, timeout=0.0001, write_timeout=None)
+        # a URL reaches a simulator's virtual port as well, eg., socket://host:port
+        ser = serial.serial_for_url(port, baudrate=38400, timeout=0.0001, write_timeout=None)
     except Exception as e:
         print("Cannot open port '{}': {}".format(port, e))
         return
@@ -218,6 +432,12 @@ def main():
             main_dump(args, ser)
         case "restore":
             main_restore(args, ser)
+        case "key":
+            main_key(args, ser)
+        case "sync":
+            main_sync(args, ser)
+        case "bench":
+            main_bench(args, ser)
 
     ser.close()
     print("Quit")
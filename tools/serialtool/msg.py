@@ -86,6 +86,10 @@ def fetch(buf: bytearray) -> Msg | None:
     msg_len = _get_hw_LE(buf, pack_begin + 2)
     pack_end = pack_begin + 6 + msg_len
 
+    if len(buf) < pack_end + 2:
+        # Packet not complete yet
+        return None
+
     if not buf.startswith(b"\xdc\xba", pack_end):
         # We've got wrong beginning
         del buf[: pack_begin + 2]
@@ -156,6 +160,28 @@ def calc_CRC(buf: bytes, off: int = 0, size: int = 0) -> int:
     return CRC
 
 
+def _make_CRC_table() -> list[int]:
+    tbl = []
+    for i in range(256):
+        crc = i << 8
+        for j in range(8):
+            crc = ((crc << 1) ^ 0x1021) if (crc & 0x8000) else (crc << 1)
+        tbl.append(0xFFFF & crc)
+    return tbl
+
+
+_CRC_TBL = _make_CRC_table()
+
+
+def crc16(buf: bytes, crc: int = 0) -> int:
+    """Same as calc_CRC(), table driven and chainable like the firmware CRC_Update()"""
+
+    for b in buf:
+        crc = (0xFFFF & (crc << 8)) ^ _CRC_TBL[(crc >> 8) ^ b]
+
+    return crc
+
+
 _OBFUS_TBL = b"\x16\x6c\x14\xe6\x2e\x91\x0d\x40\x21\x35\xd5\x40\x13\x03\xe9\x80"
 
 
@@ -0,0 +1,245 @@
+#!/usr/bin/env python3
+
+# Copyright 2025 Armel F4HWN
+# https://github.com/armel
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#     http://www.apache.org/licenses/LICENSE-2.0
+#
+#     Unless required by applicable law or agreed to in writing, software
+#     distributed under the License is distributed on an "AS IS" BASIS,
+#     WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+#     See the License for the specific language governing permissions and
+#     limitations under the License.
+
+import sys
+import csv
+import time
+import struct
+import argparse
+from collections import deque
+
+import serial
+
+# Version
+VERSION = '1.0'
+
+# Serial configuration
+DEFAULT_PORT = '/dev/ttyUSB0'
+BAUDRATE = 38400
+
+# Protocol
+CMD_SUBSCRIBE = 0x0628
+RESP_SUBSCRIBE = 0x0629
+MSG_SAMPLE = 0x062A
+OBFUSCATION = bytes([0x16, 0x6C, 0x14, 0xE6, 0x2E, 0x91, 0x0D, 0x40, 0x21, 0x35, 0xD5, 0x40, 0x13, 0x03, 0xE9, 0x80])
+SAMPLE_HEADER = struct.Struct('<HHII')  # seq, dropped, tick_10ms, fields
+
+# TELEMETRY_Field_t, in firmware order: (name, struct format)
+FIELDS = [
+    ('rssi', 'H'),
+    ('noise', 'B'),
+    ('glitch', 'B'),
+    ('agc', 'H'),
+    ('rx_gain', 'b'),
+    ('am_fix', 'b'),
+    ('squelch', 'B'),
+    ('function', 'B'),
+    ('battery', 'H'),
+    ('frequency', 'I'),
+]
+FIELD_NAMES = [name for name, _ in FIELDS]
+
+
+def crc16(data: bytes) -> int:
+    crc = 0
+    for b in data:
+        crc ^= b << 8
+        for _ in range(8):
+            crc = ((crc << 1) ^ 0x1021) if crc & 0x8000 else crc << 1
+            crc &= 0xFFFF
+    return crc
+
+
+def obfuscate(data: bytes) -> bytes:
+    return bytes(b ^ OBFUSCATION[i % 16] for i, b in enumerate(data))
+
+
+def make_packet(cmd_id: int, data: bytes) -> bytes:
+    body = cmd_id.to_bytes(2, 'little') + len(data).to_bytes(2, 'little') + data
+    body += crc16(body).to_bytes(2, 'little')
+    return b'\xAB\xCD' + (len(body) - 2).to_bytes(2, 'little') + obfuscate(body) + b'\xDC\xBA'
+
+
+class Reader:
+    """Splits the byte stream into messages: (id, payload)"""
+
+    def __init__(self, ser: serial.Serial):
+        self.ser = ser
+        self.buf = bytearray()
+
+    def read(self):
+        self.buf += self.ser.read(max(1, self.ser.in_waiting))
+        while True:
+            start = self.buf.find(b'\xAB\xCD')
+            if start < 0:
+                del self.buf[:-1]
+                return
+            if len(self.buf) - start < 4:
+                return
+            size = int.from_bytes(self.buf[start + 2:start + 4], 'little')
+            end = start + 4 + size + 2
+            if len(self.buf) < end + 2:
+                return
+            if self.buf[end:end + 2] != b'\xDC\xBA':
+                del self.buf[:start + 2]
+                continue
+            msg = obfuscate(bytes(self.buf[start + 4:start + 4 + size]))
+            del self.buf[:end + 2]
+            if len(msg) >= 4:
+                yield int.from_bytes(msg[0:2], 'little'), msg[4:]
+
+
+def decode_sample(payload: bytes):
+    seq, dropped, tick, mask = SAMPLE_HEADER.unpack_from(payload)
+    fmt = '<' + ''.join(f for i, (_, f) in enumerate(FIELDS) if mask & (1 << i))
+    values = struct.unpack_from(fmt, payload, SAMPLE_HEADER.size)
+    names = [name for i, name in enumerate(FIELD_NAMES) if mask & (1 << i)]
+    return seq, dropped, tick, dict(zip(names, values))
+
+
+def subscribe(ser: serial.Serial, reader: Reader, mask: int, period_10ms: int) -> int:
+    ser.write(make_packet(CMD_SUBSCRIBE, struct.pack('<IHH', mask, period_10ms, 0)))
+    end = time.monotonic() + 1.0
+    while time.monotonic() < end:
+        for msg_id, payload in reader.read():
+            if msg_id == RESP_SUBSCRIBE:
+                return struct.unpack_from('<I', payload)[0]
+    return -1
+
+
+class Plotter:
+
+    def __init__(self, names, window: float):
+        import matplotlib.pyplot as plt
+        self.plt = plt
+        self.window = window
+        self.names = names
+        self.t = deque()
+        self.values = {name: deque() for name in names}
+        plt.ion()
+        self.fig, axes = plt.subplots(len(names), 1, sharex=True, squeeze=False)
+        self.lines = {}
+        for ax, name in zip(axes[:, 0], names):
+            ax.set_ylabel(name)
+            ax.grid(True)
+            self.lines[name], = ax.plot([], [])
+        axes[-1, 0].set_xlabel('s')
+        self.last_draw = 0.0
+
+    def add(self, t: float, sample: dict):
+        self.t.append(t)
+        for name in self.names:
+            self.values[name].append(sample[name])
+        while self.t and self.t[0] < t - self.window:
+            self.t.popleft()
+            for name in self.names:
+                self.values[name].popleft()
+
+    def draw(self):
+        now = time.monotonic()
+        if now - self.last_draw < 0.2:
+            return
+        self.last_draw = now
+        for name, line in self.lines.items():
+            line.set_data(self.t, self.values[name])
+            line.axes.relim()
+            line.axes.autoscale_view()
+        self.fig.canvas.draw_idle()
+        self.plt.pause(0.001)
+
+
+def main():
+    parser = argparse.ArgumentParser(
+        prog="K5Telemetry",
+        description="Log and plot the live radio state of UV-K5 radios with F4HWN firmware (ENABLE_FEAT_F4HWN_TELEMETRY)",
+    )
+    parser.add_argument("--port", type=str, default=DEFAULT_PORT, help="serial port, UART cable or the radio's USB port")
+    parser.add_argument("--fields", type=str, default="rssi,noise,glitch,squelch",
+                        help=f"comma separated, 'all' or some of: {','.join(FIELD_NAMES)}")
+    parser.add_argument("--period", type=int, default=100, help="sample period in ms, 10ms steps (default 100)")
+    parser.add_argument("--csv", type=str, help="write the samples to this CSV file")
+    parser.add_argument("--plot", action="store_true", help="live plot (needs matplotlib)")
+    parser.add_argument("--window", type=float, default=30.0, help="plot window in seconds (default 30)")
+    parser.add_argument("--duration", type=float, help="stop after this many seconds")
+    parser.add_argument("--version", action="version", version=f"%(prog)s {VERSION}")
+    args = parser.parse_args()
+
+    names = FIELD_NAMES if args.fields == 'all' else [f.strip() for f in args.fields.split(',')]
+    unknown = [name for name in names if name not in FIELD_NAMES]
+    if unknown:
+        print(f"[!] Unknown fields: {','.join(unknown)}")
+        sys.exit(1)
+    mask = sum(1 << FIELD_NAMES.index(name) for name in names)
+    period_10ms = max(1, args.period // 10)
+
+    try:
+        ser = serial.Serial(args.port, BAUDRATE, timeout=0.05)
+    except serial.SerialException as e:
+        print(f"[!] Serial error: {e}")
+        sys.exit(1)
+
+    reader = Reader(ser)
+    if subscribe(ser, reader, mask, period_10ms) != mask:
+        print("[!] No subscription, is the firmware built with telemetry?")
+        sys.exit(1)
+    print(f"[✔] Streaming {','.join(names)} every {period_10ms * 10}ms")
+
+    out = None
+    writer = None
+    if args.csv:
+        out = open(args.csv, 'w', newline='')
+        writer = csv.writer(out)
+        writer.writerow(['host_time', 'tick_10ms', 'seq', 'dropped'] + names)
+
+    plotter = Plotter(names, args.window) if args.plot else None
+
+    start = time.monotonic()
+    count = 0
+    last_seq = None
+    lost = 0
+    try:
+        while args.duration is None or time.monotonic() - start < args.duration:
+            for msg_id, payload in reader.read():
+                if msg_id != MSG_SAMPLE:
+                    continue
+                seq, dropped, tick, sample = decode_sample(payload)
+                if last_seq is not None:
+                    lost += (seq - last_seq - 1) & 0xFFFF
+                last_seq = seq
+                count += 1
+                now = time.monotonic() - start
+                if writer:
+                    writer.writerow([f"{now:.3f}", tick, seq, dropped] + [sample[name] for name in names])
+                if plotter:
+                    plotter.add(now, sample)
+                else:
+                    print(f"{tick * 10:>10}ms " + " ".join(f"{name}={sample[name]}" for name in names))
+            if plotter:
+                plotter.draw()
+    except KeyboardInterrupt:
+        pass
+    finally:
+        subscribe(ser, reader, 0, 0)
+        ser.close()
+        if out:
+            out.close()
+
+    print(f"[✔] {count} samples, {lost} lost on the link")
+
+
+if __name__ == "__main__":
+    main()